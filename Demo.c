@@ -1,25 +1,88 @@
+#include <stdio.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "Thread.h"
+#include "RcuList.h"
+#include "LruCache.h"
+#include "TimingWheel.h"
+
+/* a block of received bytes, shared by every message parsed from it
+   freed when the last reference is released */
+typedef struct rx_buffer_t {
+    size_t refs;
+    size_t len;
+    uint8_t data[];
+} rx_buffer_t;
 
 typedef struct message_t {
     struct message_t* next;
     int id;
     size_t len;
     uint8_t* data;
+    struct message_block_t* block; /* NULL if allocated on its own */
+    LRU_LINK lru;                  /* for message_cache */
 } message_t;
 
+/* the headers of one batch of messages, allocated together
+   holds one reference to the rx buffer the payloads point into */
+typedef struct message_block_t {
+    size_t refs;
+    rx_buffer_t* rx;
+    message_t messages[];
+} message_block_t;
+
+/* location of one message in an rx buffer */
+typedef struct rx_message_t {
+    int id;
+    size_t offset;
+    size_t len;
+} rx_message_t;
+
 #define TEMPLATE_PREFIX message
 #define TEMPLATE_STRUCT message_t
 #define TEMPLATE_NEXT next
 #include "LinkedList.h"
 
-message_t * messages;
+#define TEMPLATE_PREFIX message
+#define TEMPLATE_STRUCT message_t
+#include "LinkedListParallel.h"
+
+#define TEMPLATE_PREFIX message_cache
+#define TEMPLATE_STRUCT message_t
+#include "LruCache.h"
+
+/* messages in the order they were received
+   tail is the NULL pointer at the end of the list, it is kept with head so
+   it can't go stale, as long as messages are only taken with take_message */
+typedef struct message_queue_t {
+    message_t* head;
+    message_t** tail;
+} message_queue_t;
+
+#define MESSAGE_QUEUE_INIT(q) { NULL, &(q).head }
 
-void receive_message(int id, size_t len, uint8_t* data)
+rx_buffer_t* rx_alloc(size_t len)
 {
-    static message_t** last_m = NULL;
+    rx_buffer_t* rx = malloc(sizeof(rx_buffer_t) + len);
 
+    if (rx) {
+        rx->refs = 1;
+        rx->len = len;
+    }
+    return rx;
+}
+
+void rx_release(rx_buffer_t* rx)
+{
+    if (--rx->refs == 0) free(rx);
+}
+
+void receive_message(message_queue_t* q, int id, size_t len, uint8_t* data)
+{
     message_t* m = malloc(sizeof(message_t));
 
     if (m) {
@@ -29,57 +92,621 @@ void receive_message(int id, size_t len, uint8_t* data)
             .data = data,
         };
 
-        if (!last_m) last_m = &messages;
+        message_push(q->tail, m);
+        q->tail = &m->next;
+    }
+}
+
+/* append a batch of n messages, whose payloads are in rx, to q
+   entries that reach past the end of rx are malformed and skipped
+   returns the number of messages received, 0 if out of memory
+ */
+size_t receive_messages(message_queue_t* q, rx_buffer_t* rx, const rx_message_t batch[], size_t n)
+{
+    message_block_t* b;
+    size_t i, k = 0;
 
-        message_push(last_m, m);
-        last_m = &m->next;
+    for (i = 0; i < n; i++) {
+        if (batch[i].offset <= rx->len && batch[i].len <= rx->len - batch[i].offset) k++;
     }
+    if (k == 0) return 0;
+
+    b = malloc(sizeof(message_block_t) + k * sizeof(message_t));
+    if (!b) return 0;
+
+    b->refs = k;
+    b->rx = rx;
+    rx->refs++;
+
+    for (i = 0, k = 0; i < n; i++) {
+        if (batch[i].offset > rx->len || batch[i].len > rx->len - batch[i].offset) continue;
+        b->messages[k] = (message_t){
+            .next = &b->messages[k + 1],
+            .id = batch[i].id,
+            .len = batch[i].len,
+            .data = rx->data + batch[i].offset,
+            .block = b,
+        };
+        k++;
+    }
+    b->messages[k - 1].next = NULL;
+
+    /* attach the whole batch at once */
+    *q->tail = &b->messages[0];
+    q->tail = &b->messages[k - 1].next;
+
+    return k;
 }
 
-void print_messages(void)
+/* remove the first message from q */
+message_t* take_message(message_queue_t* q)
+{
+    message_t* m = message_pop(&q->head);
+
+    if (!q->head) q->tail = &q->head;
+    return m;
+}
+
+/* free a message taken from messages */
+void release_message(message_t* m)
+{
+    message_block_t* b = m->block;
+
+    if (!b) {
+        free(m);
+    }
+    else if (--b->refs == 0) {
+        rx_release(b->rx);
+        free(b);
+    }
+}
+
+void print_messages(message_queue_t* q)
 {
     LL_ITERATOR it;
     message_t* m;
 
-    for_each(message, &messages, m, it)
+    for_each(message, &q->head, m, it)
     {
-        printf("%d, len:%d:, %s\n", m->id, m->len, m->data);
+        printf("%d, len:%d:, %.*s\n", m->id, (int)m->len, (int)m->len, m->data);
     }
 }
 
-void receive_message2(int id, size_t len, uint8_t* data)
+void release_messages(message_queue_t* q)
 {
-    static message_t** last_m = NULL;
+    message_t* m;
 
-    message_t* m = malloc(sizeof(message_t));
+    while ((m = take_message(q))) release_message(m);
+}
 
-    if (m) {
-        *m = (message_t){
-            .id = id,
-            .len = len,
-            .data = data,
-        };
+void run_demo(void)
+{
+    static const char* text[] = {
+        "this is the 1st message",
+        "this is the 2nd message",
+        "this is the 3rd message",
+    };
+    message_queue_t inbox = MESSAGE_QUEUE_INIT(inbox);
+    rx_message_t batch[4];
+    rx_buffer_t* rx;
+    size_t i, offset = 0;
+
+    receive_message(&inbox, 1, strlen(text[0]), (uint8_t*)text[0]);
+    receive_message(&inbox, 2, strlen(text[1]), (uint8_t*)text[1]);
+    receive_message(&inbox, 3, strlen(text[2]), (uint8_t*)text[2]);
 
-        if (!last_m) last_m = &messages;
+    print_messages(&inbox);
+    release_messages(&inbox);
 
-        message_push(last_m, m);
-        last_m = &m->next;
+    /* as if all three messages arrived in a single read */
+    rx = rx_alloc(256);
+    if (!rx) return;
+    for (i = 0; i < 3; i++) {
+        batch[i] = (rx_message_t){ (int)i + 1, offset, strlen(text[i]) };
+        memcpy(rx->data + offset, text[i], batch[i].len);
+        offset += batch[i].len;
     }
+    /* and a malformed entry reaching past the end of the buffer, which is skipped */
+    batch[3] = (rx_message_t){ 4, 250, 23 };
+    receive_messages(&inbox, rx, batch, 4);
+    rx_release(rx); /* the messages keep the buffer alive */
+
+    print_messages(&inbox);
+    release_messages(&inbox);
 }
 
-void run_demo(void)
+/* compare receive_message against receive_messages for the same payloads */
+void bench_ingest(void)
+{
+    enum { COUNT = 1 << 20, BATCH = 64, PAYLOAD = 32 };
+    static rx_message_t batch[BATCH];
+    message_queue_t inbox = MESSAGE_QUEUE_INIT(inbox);
+    rx_buffer_t* rx;
+    clock_t start;
+    double single, batched;
+    size_t i, j;
+
+    for (j = 0; j < BATCH; j++) {
+        batch[j] = (rx_message_t){ (int)j, j * PAYLOAD, PAYLOAD };
+    }
+
+    start = clock();
+    for (i = 0; i < COUNT; i += BATCH) {
+        rx = rx_alloc(BATCH * PAYLOAD);
+        if (!rx) return;
+        for (j = 0; j < BATCH; j++) {
+            receive_message(&inbox, batch[j].id, PAYLOAD, rx->data + batch[j].offset);
+        }
+        release_messages(&inbox);
+        rx_release(rx);
+    }
+    single = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (i = 0; i < COUNT; i += BATCH) {
+        rx = rx_alloc(BATCH * PAYLOAD);
+        if (!rx) return;
+        receive_messages(&inbox, rx, batch, BATCH);
+        rx_release(rx);
+        release_messages(&inbox);
+    }
+    batched = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("receive_message:  %.1f M messages/s\n", COUNT / single / 1e6);
+    printf("receive_messages: %.1f M messages/s, batches of %d\n", COUNT / batched / 1e6, BATCH);
+}
+
+/* seconds since an arbitrary point, measures wall time across threads */
+static double bench_now(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* FNV-1a checksum of the payload, summed into acc */
+void message_checksum(message_t* m, void* acc, void* param)
+{
+    uint32_t h = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < m->len; i++) {
+        h = (h ^ m->data[i]) * 16777619u;
+    }
+    *(uint64_t*)acc += h;
+}
+
+void checksum_combine(void* result, void* acc, void* param)
+{
+    *(uint64_t*)result += *(uint64_t*)acc;
+}
+
+/* checksum a list of messages with 1, 2, 4 ... threads up to one per core */
+void bench_each_parallel(void)
 {
-    receive_message(1, 25, "this is the 1st message");
-    receive_message(2, 25, "this is the 2nd message");
-    receive_message(3, 25, "this is the 3rd message");
+    enum { COUNT = 1 << 20, PAYLOAD = 256 };
+    message_t* list = NULL, * m;
+    uint8_t* payload;
+    THREAD_POOL* pool;
+    uint64_t sum, expected = 0;
+    double start, base = 0, t;
+    size_t i, threads, cores = thread_cores();
+
+    m = malloc(COUNT * sizeof(message_t));
+    payload = malloc((size_t)COUNT * PAYLOAD);
+    if (!m || !payload) {
+        free(m);
+        free(payload);
+        return;
+    }
+
+    for (i = 0; i < (size_t)COUNT * PAYLOAD; i++) payload[i] = (uint8_t)(i * 7);
+    for (i = COUNT; i-- > 0;) {
+        m[i] = (message_t){ .id = (int)i, .len = PAYLOAD, .data = payload + i * PAYLOAD };
+        message_push(&list, &m[i]);
+    }
+
+    start = bench_now();
+    message_reduce_parallel(&list, message_checksum, NULL, checksum_combine, &expected, sizeof(expected), NULL);
+    base = bench_now() - start;
+    printf("serial:     %.3fs\n", base);
+
+    for (threads = 1; threads <= cores; threads *= 2) {
+        pool = tp_create(threads);
+        if (!pool) break;
+
+        sum = 0;
+        start = bench_now();
+        message_reduce_parallel(&list, message_checksum, NULL, checksum_combine, &sum, sizeof(sum), pool);
+        t = bench_now() - start;
+        tp_destroy(pool);
+
+        printf("%2d threads: %.3fs, %.2fx%s\n", (int)threads, t, base / t, sum == expected ? "" : " WRONG RESULT");
+    }
+
+    free(m);
+    free(payload);
+}
+
+/* a routing table read by every thread and rarely changed */
+typedef struct route_t {
+    struct route_t* next;
+    uint32_t prefix;
+    int port;
+} route_t;
+
+#define TEMPLATE_PREFIX route
+#define TEMPLATE_STRUCT route_t
+#include "RcuList.h"
+
+#define TEMPLATE_PREFIX route_locked
+#define TEMPLATE_STRUCT route_t
+#include "LinkedList.h"
+
+enum { ROUTES = 64, LOOKUPS = 1 << 20 };
+
+typedef struct route_bench_t {
+    RCU_DOMAIN domain;
+    mutex_t lock; /* for the locked table */
+    route_t* head;
+    int rcu;
+    size_t found[64];
+} route_bench_t;
+
+int route_match(route_t* r, void* prefix)
+{
+    return r->prefix != *(uint32_t*)prefix;
+}
+
+void route_reclaim(void* item, void* param)
+{
+    free(item);
+}
+
+static route_bench_t route_bench;
+
+static THREAD_FUNCTION(route_reader, arg)
+{
+    size_t id = (size_t)arg, i, found = 0;
+    RCU_READER reader;
+    uint32_t prefix;
+
+    if (route_bench.rcu) rcu_register(&route_bench.domain, &reader);
+    for (i = 0; i < LOOKUPS; i++) {
+        prefix = (uint32_t)((i * 7 + id) % ROUTES);
+        if (route_bench.rcu) {
+            rcu_read_lock(&route_bench.domain, &reader);
+            found += route_find(&route_bench.head, &prefix, route_match) != NULL;
+            rcu_read_unlock(&reader);
+        }
+        else {
+            mutex_lock(&route_bench.lock);
+            found += route_locked_find(&route_bench.head, &prefix, route_match) != NULL;
+            mutex_unlock(&route_bench.lock);
+        }
+    }
+    if (route_bench.rcu) rcu_unregister(&route_bench.domain, &reader);
+    route_bench.found[id] = found;
+    THREAD_RETURN;
+}
+
+/* time LOOKUPS lookups on each of n threads, returns lookups per second */
+static double route_run(size_t n)
+{
+    thread_t threads[64];
+    double start, t;
+    size_t i, started;
+
+    start = bench_now();
+    for (started = 0; started < n; started++) {
+        if (thread_start(&threads[started], route_reader, (void*)started)) break;
+    }
+    for (i = 0; i < started; i++) thread_join(threads[i]);
+    t = bench_now() - start;
+
+    return (double)started * LOOKUPS / t;
+}
+
+/* compare RCU readers against a mutex locked list with 1, 2, 4 ... threads up to one per core */
+void bench_rcu_readers(void)
+{
+    route_t* r;
+    double rcu, locked;
+    size_t i, threads, cores = thread_cores();
+
+    rcu_init(&route_bench.domain, route_reclaim, NULL);
+    mutex_init(&route_bench.lock);
+    for (i = 0; i < ROUTES; i++) {
+        r = malloc(sizeof(route_t));
+        if (!r) break;
+        r->prefix = (uint32_t)i;
+        r->port = (int)i % 8;
+        route_push(&route_bench.domain, &route_bench.head, r);
+    }
+
+    if (cores > 64) cores = 64;
+    for (threads = 1; threads <= cores; threads *= 2) {
+        route_bench.rcu = 0;
+        locked = route_run(threads);
+        route_bench.rcu = 1;
+        rcu = route_run(threads);
+        printf("%2d threads: locked %.1f M lookups/s, rcu %.1f M lookups/s, %.2fx\n",
+            (int)threads, locked / 1e6, rcu / 1e6, rcu / locked);
+    }
+
+    while ((r = route_bench.head)) route_remove(&route_bench.domain, &route_bench.head, r);
+    rcu_destroy(&route_bench.domain);
+    mutex_destroy(&route_bench.lock);
+}
+
+/* largest list sorted by bench_sort_scale, 16 bytes per node */
+#ifndef LL_BENCH_SORT_NODES
+#define LL_BENCH_SORT_NODES ((size_t)1 << 24)
+#endif
+
+typedef struct record_t {
+    struct record_t* next;
+    uint32_t key;
+} record_t;
+
+#define TEMPLATE_PREFIX record
+#define TEMPLATE_STRUCT record_t
+#include "LinkedList.h"
+
+static size_t record_compares;
+
+int record_compare(record_t* x, record_t* y)
+{
+    record_compares++;
+    return (x->key <= y->key) - (x->key > y->key);
+}
+
+static record_t* record_build(record_t* buf, size_t n)
+{
+    record_t* head = NULL;
+    uint32_t seed = 1;
+    size_t i;
+
+    for (i = n; i-- > 0;) {
+        seed = seed * 1664525 + 1013904223;
+        buf[i].key = seed >> 8;
+        record_push(&head, &buf[i]);
+    }
+    return head;
+}
+
+/* sort 2^16 ... LL_BENCH_SORT_NODES random records with both engines
+   time and comparisons are reported per n log2(n), flat columns mean the
+   sorts stay n log(n) as the lists grow */
+void bench_sort_scale(void)
+{
+    record_t* buf = malloc(LL_BENCH_SORT_NODES * sizeof(record_t));
+    record_t* head;
+    double start, t, nlogn;
+    size_t n;
+    int engine;
+
+    if (!buf) return;
+
+    for (n = (size_t)1 << 16; n <= LL_BENCH_SORT_NODES; n *= 2) {
+        nlogn = n * (log((double)n) / log(2.0));
+        for (engine = 1; engine <= 2; engine++) {
+            head = record_build(buf, n);
+            record_compares = 0;
+            start = bench_now();
+            if (engine == 1) record_sort(&head, record_compare);
+            else record_sort2(&head, record_compare);
+            t = bench_now() - start;
+
+            printf("sort%s n: %10.0f, %.2f ns and %.3f compares per n log2(n)%s\n",
+                engine == 1 ? " " : "2", (double)n, t * 1e9 / nlogn, record_compares / nlogn,
+                record_length(&head) == n ? "" : " WRONG LENGTH");
+        }
+    }
+
+    free(buf);
+}
+
+size_t message_hash(void* id)
+{
+    return (size_t)*(int*)id * 2654435761u;
+}
+
+int message_has_id(message_t* m, void* id)
+{
+    return m->id != *(int*)id;
+}
+
+/* look up random message ids in a cache of the most recently used messages,
+   first as a plain list: find, then remove and push to the front on a hit,
+   deduct the oldest and push on a miss. Then with message_cache */
+void bench_message_cache(void)
+{
+    enum { CAPACITY = 1024, IDS = 2048, LOOKUPS = 1 << 20 };
+    static message_t pool[IDS];
+    message_t* list = NULL, * m;
+    LRU_CACHE* cache;
+    uint32_t seed;
+    size_t i, count, hits_list = 0, hits_lru = 0;
+    double start, t_list, t_lru;
+    int id;
+
+    for (i = 0; i < IDS; i++) pool[i] = (message_t){ .id = (int)i };
+
+    seed = 1;
+    count = 0;
+    start = bench_now();
+    for (i = 0; i < LOOKUPS; i++) {
+        seed = seed * 1664525 + 1013904223;
+        id = (int)((seed >> 8) % IDS);
+        m = message_find(&list, &id, message_has_id);
+        if (m) {
+            hits_list++;
+            message_remove(&list, m);
+        }
+        else {
+            if (count == CAPACITY) message_deduct(&list);
+            else count++;
+            m = &pool[id];
+        }
+        message_push(&list, m);
+    }
+    t_list = bench_now() - start;
+
+    cache = message_cache_create(CAPACITY, message_hash, message_has_id, NULL, NULL);
+    if (!cache) return;
+
+    seed = 1;
+    start = bench_now();
+    for (i = 0; i < LOOKUPS; i++) {
+        seed = seed * 1664525 + 1013904223;
+        id = (int)((seed >> 8) % IDS);
+        if (message_cache_get(cache, &id)) hits_lru++;
+        else message_cache_put(cache, &pool[id], &pool[id].id);
+    }
+    t_lru = bench_now() - start;
+    message_cache_destroy(cache);
+
+    printf("list:          %.2f M lookups/s, %d hits\n", LOOKUPS / t_list / 1e6, (int)hits_list);
+    printf("message_cache: %.2f M lookups/s, %d hits, %.1fx\n", LOOKUPS / t_lru / 1e6, (int)hits_lru, t_list / t_lru);
+}
+
+/* a message waiting for its acknowledgement, with a deadline */
+typedef struct timeout_t {
+    struct timeout_t* next;
+    uint64_t deadline;
+    int pending;
+    TW_LINK tw;
+} timeout_t;
+
+#define TEMPLATE_PREFIX timeout
+#define TEMPLATE_STRUCT timeout_t
+#include "LinkedList.h"
+
+#define TEMPLATE_PREFIX timeout_wheel
+#define TEMPLATE_STRUCT timeout_t
+#include "TimingWheel.h"
+
+int timeout_earlier(timeout_t* x, timeout_t* y)
+{
+    return (x->deadline <= y->deadline) - (x->deadline > y->deadline);
+}
+
+/* every tick BATCH timeouts are started and CANCEL random ones acknowledged,
+   first with a list kept sorted by deadline: each batch is sorted and merged
+   in, expired timeouts are popped from the front. Then with a timing wheel */
+void bench_timeouts(void)
+{
+    enum { TICKS = 2048, BATCH = 64, CANCEL = 4, SPREAD = 2048, COUNT = TICKS * BATCH };
+    timeout_t* pool = malloc(COUNT * sizeof(timeout_t));
+    timeout_t* list = NULL, * batch, * t;
+    static TIMING_WHEEL wheel;
+    uint32_t seed;
+    uint64_t now;
+    size_t i, n, expired_list = 0, expired_wheel = 0;
+    double start, t_list, t_wheel;
+
+    if (!pool) return;
+
+    seed = 1;
+    n = 0;
+    start = bench_now();
+    for (now = 1; now <= TICKS + SPREAD; now++) {
+        batch = NULL;
+        for (i = 0; i < BATCH && n < COUNT; i++, n++) {
+            seed = seed * 1664525 + 1013904223;
+            pool[n] = (timeout_t){ .deadline = now + (seed >> 8) % SPREAD, .pending = 1 };
+            timeout_push(&batch, &pool[n]);
+        }
+        timeout_sort(&batch, timeout_earlier);
+        timeout_merge(&list, batch, timeout_earlier);
+
+        for (i = 0; i < CANCEL && n; i++) {
+            seed = seed * 1664525 + 1013904223;
+            t = &pool[(seed >> 8) % n];
+            if (t->pending) {
+                t->pending = 0;
+                timeout_remove(&list, t);
+            }
+        }
+
+        while (list && list->deadline <= now) {
+            t = timeout_pop(&list);
+            t->pending = 0;
+            expired_list++;
+        }
+    }
+    t_list = bench_now() - start;
+
+    seed = 1;
+    n = 0;
+    timeout_wheel_init(&wheel, 0);
+    start = bench_now();
+    for (now = 1; now <= TICKS + SPREAD; now++) {
+        for (i = 0; i < BATCH && n < COUNT; i++, n++) {
+            seed = seed * 1664525 + 1013904223;
+            pool[n] = (timeout_t){ .deadline = now + (seed >> 8) % SPREAD };
+            timeout_wheel_schedule(&wheel, &pool[n], pool[n].deadline);
+        }
+
+        for (i = 0; i < CANCEL && n; i++) {
+            seed = seed * 1664525 + 1013904223;
+            timeout_wheel_cancel(&wheel, &pool[(seed >> 8) % n]);
+        }
+
+        for (t = timeout_wheel_advance(&wheel, now); t; t = t->tw.next) expired_wheel++;
+    }
+    t_wheel = bench_now() - start;
+
+    printf("sorted list:  %.3fs, %d expired\n", t_list, (int)expired_list);
+    printf("timing wheel: %.3fs, %d expired, %.1fx\n", t_wheel, (int)expired_wheel, t_list / t_wheel);
+
+    free(pool);
+}
+
+/* > 0 while m is before the id in a list sorted by ascending id */
+int message_id_order(message_t* m, void* id)
+{
+    return *(int*)id - m->id;
+}
+
+/* resolve the ids of an ACK against the messages waiting for one,
+   with a find for each id, with find_many, and with find_many_sorted */
+void bench_find_many(void)
+{
+    enum { COUNT = 1 << 20, ACKED = 64, ROUNDS = 4 };
+    static message_t m[COUNT];
+    static int ids[ACKED];
+    static void* keys[ACKED];
+    static message_t* results[ACKED];
+    message_t* list = NULL;
+    double start, t_find, t_many, t_sorted;
+    size_t i, r, missing = 0;
+
+    for (i = COUNT; i-- > 0;) {
+        m[i] = (message_t){ .id = (int)i * 2 };
+        message_push(&list, &m[i]);
+    }
+    /* ids spread over the list, every 8th one never sent */
+    for (i = 0; i < ACKED; i++) {
+        ids[i] = (int)(i * (2 * COUNT / ACKED)) + (i % 8 == 7);
+        keys[i] = &ids[i];
+    }
 
-    print_messages();
+    start = bench_now();
+    for (r = 0; r < ROUNDS; r++)
+        for (i = 0; i < ACKED; i++) results[i] = message_find(&list, &ids[i], message_has_id);
+    t_find = bench_now() - start;
 
-    messages = NULL;
+    start = bench_now();
+    for (r = 0; r < ROUNDS; r++) missing = message_find_many(&list, keys, ACKED, message_has_id, results);
+    t_many = bench_now() - start;
 
-    receive_message2(1, 25, "this is the 1st message");
-    receive_message2(2, 25, "this is the 2nd message");
-    receive_message2(3, 25, "this is the 3rd message");
+    start = bench_now();
+    for (r = 0; r < ROUNDS; r++) missing = message_find_many_sorted(&list, keys, ACKED, message_id_order, results);
+    t_sorted = bench_now() - start;
 
-    print_messages();
+    printf("find:             %.3f ms per ack of %d ids\n", t_find * 1e3 / ROUNDS, ACKED);
+    printf("find_many:        %.3f ms per ack, %.1fx\n", t_many * 1e3 / ROUNDS, t_find / t_many);
+    printf("find_many_sorted: %.3f ms per ack, %.1fx, %d ids not found\n", t_sorted * 1e3 / ROUNDS, t_find / t_sorted, (int)missing);
 }
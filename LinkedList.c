@@ -1,17 +1,44 @@
 #include "LinkedList.h"
 
-/* assumes variable "o" is the offset where the void * NEXT element is located */
-#define NEXT(x) offsetin(x, o, void *)
+/* This file is compiled once for each link mode, the mode picks how a link
+   is stored, see LinkedListRel.c and LinkedListIdx.c. The default mode stores
+   plain pointers.
+    * LL_NAME: prefix of the generated functions
+    * LL_LINK: type of the NEXT element (and of the head)
+    * LL_HEAD: type of the pointer to the head
+    * LL_CONTEXT: type of "o", everything needed to follow a link
+    * LL_OFFSET(o): the offset where the NEXT element is located
+    * LL_ITER_CONTEXT: defined if ll_iter needs "o" to follow the head
+    * GET(l): the item pointed to by the LL_LINK at address l
+    * SET(l, v): make the LL_LINK at address l point to item v
+ */
+#ifndef LL_NAME
+#define LL_NAME ll
+#define LL_LINK void *
+#define LL_HEAD LL_TYPE
+#define LL_CONTEXT size_t
+#define LL_OFFSET(o) (o)
+#define GET(l) (*(l))
+#define SET(l, v) (*(l) = (v))
+#endif
+
+#define LL_FUNCTION(name) PPCAT(PPCAT(LL_NAME, _), name)
+#define LL_PRIVATE(name) PPCAT(_, LL_FUNCTION(name))
+
+/* assumes variable "o" is the LL_CONTEXT of the list */
+#define LINK(x) (&offsetin(x, LL_OFFSET(o), LL_LINK))
+#define NEXT(x) GET(LINK(x))
+#define SET_NEXT(x, v) SET(LINK(x), v)
 
 /* determine the length of the linked list
    Complexity O(n)
  */
-int ll_length(LL_TYPE head, const size_t o)
+size_t LL_FUNCTION(length)(LL_HEAD head, const LL_CONTEXT o)
 {
     void * x;
-    int len = 0;
+    size_t len = 0;
     /* iterate to end of list */
-    for(x=*head; x; x = NEXT(x))
+    for(x=GET(head); x; x = NEXT(x))
         len++;
     return len;
 }
@@ -19,23 +46,23 @@ int ll_length(LL_TYPE head, const size_t o)
 /* push item to the beginning of the linked list
    Complexity O(1)
  */
-void ll_push(LL_TYPE head, const size_t o, void * const item)
+void LL_FUNCTION(push)(LL_HEAD head, const LL_CONTEXT o, void * const item)
 {
-    NEXT(item) = *head;
-    *head = item;
+    SET_NEXT(item, GET(head));
+    SET(head, item);
 }
 
 /* pop item from the beginning of the linked list
    returns the popped item
    Complexity O(1)
  */
-void * ll_pop(LL_TYPE head, const size_t o)
+void * LL_FUNCTION(pop)(LL_HEAD head, const LL_CONTEXT o)
 {
     void * x;
-    x = *head;
-    if(*head != NULL) {
-        *head = NEXT(x);
-        NEXT(x) = NULL;
+    x = GET(head);
+    if(x != NULL) {
+        SET(head, NEXT(x));
+        SET_NEXT(x, NULL);
     }
     return x;
 }
@@ -43,15 +70,15 @@ void * ll_pop(LL_TYPE head, const size_t o)
 /* append item to the end of the linked list
    Complexity O(n)
  */
-void ll_append(LL_TYPE head, const size_t o, void * const item)
+void LL_FUNCTION(append)(LL_HEAD head, const LL_CONTEXT o, void * const item)
 {
     void * x;
-    if(*head == NULL) *head = item;
+    if(GET(head) == NULL) SET(head, item);
     else {
         /* iterate to end of list */
-        for(x=*head; NEXT(x); x = NEXT(x))
+        for(x=GET(head); NEXT(x); x = NEXT(x))
             ;
-        NEXT(x) = item;
+        SET_NEXT(x, item);
     }
 }
 
@@ -59,16 +86,16 @@ void ll_append(LL_TYPE head, const size_t o, void * const item)
    returns the deducted item
    Complexity O(n)
  */
-void * ll_deduct(LL_TYPE head, const size_t o)
+void * LL_FUNCTION(deduct)(LL_HEAD head, const LL_CONTEXT o)
 {
     void * x, * prev;
-    if(*head == NULL) return NULL; /* empty list */
+    if(GET(head) == NULL) return NULL; /* empty list */
     else {
-        prev = *head;
+        prev = GET(head);
         /* iterate to end of list */
-        for(x=*head; NEXT(x); x = NEXT(x))
+        for(x=GET(head); NEXT(x); x = NEXT(x))
             prev = x; /* save prev at every step */
-        NEXT(prev) = NULL;
+        SET_NEXT(prev, NULL);
         return x;
     }
 }
@@ -77,26 +104,26 @@ void * ll_deduct(LL_TYPE head, const size_t o)
    returns the removed item
    Complexity O(n)
  */
-void * ll_remove(LL_TYPE head, const size_t o, void * const item)
+void * LL_FUNCTION(remove)(LL_HEAD head, const LL_CONTEXT o, void * const item)
 {
     void * x;
-    if(item == NULL || *head == NULL) return NULL;
+    if(item == NULL || GET(head) == NULL) return NULL;
 
     /* item is first in the list needs special handling */
-    if(*head == item)
+    if(GET(head) == item)
     {
-        *head = NEXT(item); /* remove the item */
-        NEXT(item) = NULL;
+        SET(head, NEXT(item)); /* remove the item */
+        SET_NEXT(item, NULL);
         return item;
     }
 
     /* iterate till item is found or end of list */
-    for(x=*head; NEXT(x); x = NEXT(x))
+    for(x=GET(head); NEXT(x); x = NEXT(x))
     {
         if(NEXT(x) == item)
         {
-            NEXT(x) = NEXT(item); /* remove the item */
-            NEXT(item) = NULL;
+            SET_NEXT(x, NEXT(item)); /* remove the item */
+            SET_NEXT(item, NULL);
             return item;
         }
     }
@@ -109,12 +136,12 @@ void * ll_remove(LL_TYPE head, const size_t o, void * const item)
    returns the found item, or NULL if not fount
    Complexity O(n)
  */
-void * ll_find(const LL_TYPE head, const size_t o, void * const item, int (*compare)(void *, void *))
+void * LL_FUNCTION(find)(const LL_HEAD head, const LL_CONTEXT o, void * const item, int (*compare)(void *, void *))
 {
     void * x;
 
     /* iterate till item is found or end or list */
-    for(x=*head; x; x = NEXT(x))
+    for(x=GET(head); x; x = NEXT(x))
     {
         if(compare(x, item) == 0) return x;
     }
@@ -123,6 +150,73 @@ void * ll_find(const LL_TYPE head, const size_t o, void * const item, int (*comp
     return NULL;
 }
 
+/* searches for each of the m keys in a single pass over the linked list
+   results[i] is set to the first item matching keys[i], or NULL if not found
+   the pass stops as soon as every key is found
+   returns the number of keys not found
+   Complexity O(n * m)
+ */
+size_t LL_FUNCTION(find_many)(const LL_HEAD head, const LL_CONTEXT o, void * const * const keys, const size_t m,
+    int (*compare)(void *, void *), void ** const results)
+{
+    void * x;
+    size_t i, missing = m;
+
+    for(i=0; i < m; i++) results[i] = NULL;
+
+    /* iterate till every key is found or end of list */
+    for(x=GET(head); x && missing; x = NEXT(x))
+    {
+        for(i=0; i < m; i++)
+        {
+            /* skip keys already found earlier in the list */
+            if(results[i] == NULL && compare(x, keys[i]) == 0)
+            {
+                results[i] = x;
+                missing--;
+            }
+        }
+    }
+
+    return missing;
+}
+
+/* searches for each of the m keys, which are sorted in the same order as
+   the linked list, in a single merge-like pass
+   results[i] is set to the first item matching keys[i], or NULL if not found
+   the pass stops after the last key
+   compare must return:
+     > 0 if the item (first argument) is placed before the key (second argument)
+     == 0 if the item has the key
+     < 0 if the item is placed after the key
+   returns the number of keys not found
+   Complexity O(n + m)
+ */
+size_t LL_FUNCTION(find_many_sorted)(const LL_HEAD head, const LL_CONTEXT o, void * const * const keys, const size_t m,
+    int (*compare)(void *, void *), void ** const results)
+{
+    void * x = GET(head);
+    size_t i = 0, missing = 0;
+    int c;
+
+    while(i < m)
+    {
+        c = x ? compare(x, keys[i]) : -1;
+        if(c > 0)
+        { /* the key is further down the list */
+            x = NEXT(x);
+            continue;
+        }
+
+        /* x stays, equal keys may follow */
+        results[i] = c == 0 ? x : NULL;
+        if(c != 0) missing++;
+        i++;
+    }
+
+    return missing;
+}
+
 /* merge linked list "list" into head
    compare must return: 
      >= 0 if the first argument should be placed before the second
@@ -130,27 +224,27 @@ void * ll_find(const LL_TYPE head, const size_t o, void * const item, int (*comp
    Complexity O(n)
    returns pointer to last visited element of merged result
  */
-static void * _ll_merge(LL_TYPE head, const size_t o, void * const list, int (*compare)(void *, void *))
+static void * LL_PRIVATE(merge)(LL_HEAD head, const LL_CONTEXT o, void * const list, int (*compare)(void *, void *))
 {
     void * x, * y, * prev = NULL;
     
     /* sanity check*/
-    if(compare == NULL || list == NULL) return *head;
+    if(compare == NULL || list == NULL) return GET(head);
 
     /* iterate till end of either list */
-    for(x=*head, y=list; x && y;)
+    for(x=GET(head), y=list; x && y;)
     {
         if(compare(x, y) >= 0)
         {
-            if(prev) NEXT(prev) = x;
-            else *head = x;
+            if(prev) SET_NEXT(prev, x);
+            else SET(head, x);
             prev = x;
             x = NEXT(x);
         }
         else
         {
-            if(prev) NEXT(prev) = y;
-            else *head = y;
+            if(prev) SET_NEXT(prev, y);
+            else SET(head, y);
             prev = y;
             y = NEXT(y);
         }
@@ -159,21 +253,21 @@ static void * _ll_merge(LL_TYPE head, const size_t o, void * const list, int (*c
     /* append remaining tail to result*/
     if(x)
     {
-        if(prev) NEXT(prev) = x;
-        else *head = x;
+        if(prev) SET_NEXT(prev, x);
+        else SET(head, x);
         return x;
     }
     else /*if(y), it is impossible for both x and y to be null */
     {
-        if(prev) NEXT(prev) = y;
-        else *head = y;
+        if(prev) SET_NEXT(prev, y);
+        else SET(head, y);
         return y;
     }
 }
 
-void ll_merge(LL_TYPE head, const size_t o, void * const list, int (*compare)(void *, void *))
+void LL_FUNCTION(merge)(LL_HEAD head, const LL_CONTEXT o, void * const list, int (*compare)(void *, void *))
 {
-    _ll_merge(head, o, list, compare);
+    LL_PRIVATE(merge)(head, o, list, compare);
 }
 
 /* sort linked list
@@ -182,7 +276,7 @@ void ll_merge(LL_TYPE head, const size_t o, void * const list, int (*compare)(vo
      < 0 if the first argument should be placed after the second
    Complexity O(n log(n))
  */
-void ll_sort(LL_TYPE head, const size_t o, int (*compare)(void *, void *))
+void LL_FUNCTION(sort)(LL_HEAD head, const LL_CONTEXT o, int (*compare)(void *, void *))
 {
     /* each merge requires sub lists which are disconnected from the 
        main list, merged, then re-attached to the main list
@@ -197,44 +291,46 @@ void ll_sort(LL_TYPE head, const size_t o, int (*compare)(void *, void *))
        M and H properly, then T can be appended to H.
     */
     
-    void ** H, *M, *T, *x;
-    int i, j, len = 0;
+    LL_LINK * H;
+    void *M, *T, *x;
+    unsigned int i;
+    size_t j, len = 0;
 
     /* sanity check*/
     if(compare == NULL) return;
 
     /* iterate once, then again for each multiple of 2 items */
-    for(i=0; i == 0 || (len - 1) >> i; i++)
+    for(i=0; i == 0 || (len > 1 && (len - 1) >> i); i++)
     {
         H = head;
         M = NULL;
-        x = *H;
+        x = GET(H);
 
         for(j=1; x; j++)
         {
             if(NEXT(x) == NULL)
             { /* last merge for iteration */
-                _ll_merge(H, o, M, compare);
+                LL_PRIVATE(merge)(H, o, M, compare);
                 x = NULL;
             }
-            else if(j % (1 << (i + 1)) == 0)
+            else if(j % ((size_t)2 << i) == 0)
             { /* at end of M list, split off T then merge */
                 T = NEXT(x);
-                NEXT(x) = NULL;
-                x = _ll_merge(H, o, M, compare);
+                SET_NEXT(x, NULL);
+                x = LL_PRIVATE(merge)(H, o, M, compare);
                 /* find end of merged result */
                 while(NEXT(x)) x = NEXT(x);
                 /* re-connect T */
-                NEXT(x) = T;
+                SET_NEXT(x, T);
                 /* update H for next merge */
-                H = &NEXT(x);
+                H = LINK(x);
                 M = NULL;
                 x = T;
             }
-            else if(j % (1 << i) == 0)
+            else if(j % ((size_t)1 << i) == 0)
             { /* at end of H list, split off M then continue */
                 M = NEXT(x);
-                NEXT(x) = NULL;
+                SET_NEXT(x, NULL);
                 x = M;
             }
             else
@@ -257,16 +353,17 @@ void ll_sort(LL_TYPE head, const size_t o, int (*compare)(void *, void *))
    Complexity O(n)
    returns pointer to NEXT pointer at end of merged result
  */
-void ** _ll_merge2(LL_TYPE head, const size_t o, void * const list, int (*compare)(void *, void *), const int n)
+LL_LINK * LL_PRIVATE(merge2)(LL_HEAD head, const LL_CONTEXT o, void * const list, int (*compare)(void *, void *), const size_t n)
 {
-    void * x, * y, ** prev = NULL;
-    int xi, yi;
+    void * x, * y;
+    LL_LINK * prev = NULL;
+    size_t xi, yi;
 
     /* sanity check*/
     if(compare == NULL) return head;
 
     prev = head;
-    x=*head;
+    x=GET(head);
     y=list;
     xi = yi = 0;
     
@@ -276,11 +373,11 @@ void ** _ll_merge2(LL_TYPE head, const size_t o, void * const list, int (*compar
         /* check if list x is done */
         if(xi >= n || x == NULL)
         {
-            *prev = y;
+            SET(prev, y);
             /* iterate till end of list y */
             while(yi < n && y)
             {
-                prev = &NEXT(y);
+                prev = LINK(y);
                 y = NEXT(y);
                 yi++;
             }
@@ -290,31 +387,31 @@ void ** _ll_merge2(LL_TYPE head, const size_t o, void * const list, int (*compar
         /* check if list y is done */
         if(yi >= n || y == NULL)
         {
-            *prev = x;
+            SET(prev, x);
             /* iterate till end of list x */
             while(xi < n && x)
             {
-                prev = &NEXT(x);
+                prev = LINK(x);
                 x = NEXT(x);
                 xi++;
             }
             /* ensure tail of y is appended to result*/
-            *prev = y;
+            SET(prev, y);
             return prev;
         }
         
         /* compare x and y to see which is next */
         if(compare(x, y) >= 0)
         {
-            *prev = x;
-            prev = &NEXT(x);
+            SET(prev, x);
+            prev = LINK(x);
             x = NEXT(x);
             xi++;
         }
         else
         {
-            *prev = y;
-            prev = &NEXT(y);
+            SET(prev, y);
+            prev = LINK(y);
             y = NEXT(y);
             yi++;
         }
@@ -327,7 +424,7 @@ void ** _ll_merge2(LL_TYPE head, const size_t o, void * const list, int (*compar
      < 0 if the first argument should be placed after the second
    Complexity O(n log(n))
  */
-void ll_sort2(LL_TYPE head, const size_t o, int (*compare)(void *, void *))
+void LL_FUNCTION(sort2)(LL_HEAD head, const LL_CONTEXT o, int (*compare)(void *, void *))
 {
     /* merge2 requires the start pointer of both lists to merge
        as such the list being sorted must be iterated through
@@ -338,25 +435,27 @@ void ll_sort2(LL_TYPE head, const size_t o, int (*compare)(void *, void *))
        each merge
     */
 
-    void ** H,/* *M, *T,*/ *x;
-    int i, j, len = 0;
+    LL_LINK * H;
+    void /* *M, *T,*/ *x;
+    unsigned int i;
+    size_t j, len = 0;
 
     /* sanity check*/
     if(compare == NULL) return;
 
     /* iterate once, then again for each multiple of 2 items */
-    for(i=0; i == 0 || (len - 1) >> i; i++)
+    for(i=0; i == 0 || (len > 1 && (len - 1) >> i); i++)
     {
         H = head;
-        x = *H ? NEXT(*H) : NULL;
+        x = GET(H) ? NEXT(GET(H)) : NULL;
 
         for(j=1; x; j++)
         {
-            if(j % (1 << i) == 0)
+            if(j % ((size_t)1 << i) == 0)
             { /* at end of 1st list, merge with up to 2^i items */
-                H = _ll_merge2(H, o, x, compare, 1 << i);
-                j += 1 << i; /* assume other half has 2^i items */
-                x = *H ? NEXT(*H) : NULL;
+                H = LL_PRIVATE(merge2)(H, o, x, compare, (size_t)1 << i);
+                j += (size_t)1 << i; /* assume other half has 2^i items */
+                x = GET(H) ? NEXT(GET(H)) : NULL;
             }
             else
             {
@@ -365,32 +464,225 @@ void ll_sort2(LL_TYPE head, const size_t o, int (*compare)(void *, void *))
             }
         }
 
-        /* first time through also calculate len*/
-        if(i == 0) len = j - 1;
+        /* first time through also calculate len,
+           counting an odd node left at the end without a partner */
+        if(i == 0) len = j - 1 + (GET(H) != NULL);
+    }
+}
+
+/* which nodes are kept by LL_PRIVATE(combine), all other nodes are dropped */
+#define LL_KEEP_X 1     /* nodes from head without an equal node in list */
+#define LL_KEEP_Y 2     /* nodes from list without an equal node in head */
+#define LL_KEEP_MATCH 4 /* nodes from head with an equal node in list */
+
+/* append node n to the list of dropped nodes "*dropped", "*last" is its last node
+   Complexity O(1)
+ */
+static void LL_PRIVATE(drop)(const LL_CONTEXT o, void ** const dropped, void ** const last, void * const n)
+{
+    if(*last) SET_NEXT(*last, n);
+    else *dropped = n;
+    *last = n;
+}
+
+/* relink node n after "*prev" if k is set, otherwise drop it
+   Complexity O(1)
+ */
+static void LL_PRIVATE(take)(const LL_CONTEXT o, LL_LINK ** const prev, void ** const dropped, void ** const last,
+                             void * const n, const int k)
+{
+    if(k)
+    {
+        SET(*prev, n);
+        *prev = LINK(n);
     }
+    else LL_PRIVATE(drop)(o, dropped, last, n);
+}
+
+/* walk the sorted lists "*head" and "list" once, relinking the nodes that
+   are kept into head and the nodes that are dropped into a separate list
+   nodes from list with an equal node in head are always dropped
+   on a match the whole run of equal nodes is taken from both lists, so
+   duplicates in either list are handled like the first node of their run
+   compare must return:
+     > 0 if the first argument should be placed before the second
+     == 0 if the arguments are equal
+     < 0 if the first argument should be placed after the second
+   Complexity O(n)
+   returns the list of dropped nodes
+ */
+static void * LL_PRIVATE(combine)(LL_HEAD head, const LL_CONTEXT o, void * list, int (*compare)(void *, void *), const int keep)
+{
+    void * x, * y, * m, * dropped = NULL, * last = NULL;
+    LL_LINK * prev;
+    int c, k;
+
+    prev = head;
+    x = GET(head);
+    y = list;
+
+    /* iterate till end of either list */
+    while(x && y)
+    {
+        c = compare(x, y);
+        if(c > 0)
+        {
+            m = x;
+            x = NEXT(x);
+            LL_PRIVATE(take)(o, &prev, &dropped, &last, m, keep & LL_KEEP_X);
+        }
+        else if(c < 0)
+        {
+            m = y;
+            y = NEXT(y);
+            LL_PRIVATE(take)(o, &prev, &dropped, &last, m, keep & LL_KEEP_Y);
+        }
+        else
+        {
+            /* drop the run of nodes in list equal to x */
+            m = x;
+            do
+            {
+                LL_PRIVATE(drop)(o, &dropped, &last, y);
+                y = NEXT(y);
+            }
+            while(y && compare(m, y) == 0);
+
+            /* then handle the run of nodes in head equal to it */
+            do
+            {
+                m = x;
+                x = NEXT(x);
+                LL_PRIVATE(take)(o, &prev, &dropped, &last, m, keep & LL_KEEP_MATCH);
+            }
+            while(x && compare(x, m) == 0);
+        }
+    }
+
+    /* the remaining tail is already terminated, attach it whole */
+    if(x)
+    {
+        k = keep & LL_KEEP_X;
+    }
+    else
+    {
+        x = y;
+        k = keep & LL_KEEP_Y;
+    }
+
+    if(k)
+    {
+        SET(prev, x);
+        if(last) SET_NEXT(last, NULL);
+    }
+    else
+    {
+        SET(prev, NULL);
+        if(x) LL_PRIVATE(drop)(o, &dropped, &last, x);
+        else if(last) SET_NEXT(last, NULL);
+    }
+
+    return dropped;
+}
+
+/* remove consecutive equal nodes from the linked list, only the first of
+   each run is kept, for a sorted list this leaves only unique nodes
+   compare must return:
+     == 0 if the arguments are equal
+   Complexity O(n)
+   returns the list of removed nodes
+ */
+void * LL_FUNCTION(unique)(LL_HEAD head, const LL_CONTEXT o, int (*compare)(void *, void *))
+{
+    void * x, * y, * dropped = NULL, * last = NULL;
+
+    x = GET(head);
+
+    if(x)
+    {
+        /* iterate till end of list, x is the last node kept */
+        while((y = NEXT(x)))
+        {
+            if(compare(x, y) == 0)
+            {
+                SET_NEXT(x, NEXT(y)); /* remove the node */
+                LL_PRIVATE(drop)(o, &dropped, &last, y);
+            }
+            else x = y;
+        }
+    }
+
+    if(last) SET_NEXT(last, NULL);
+    return dropped;
+}
+
+/* union of sorted linked list "list" into head
+   nodes in list equal to a node in head are removed, duplicates included
+   compare must return:
+     > 0 if the first argument should be placed before the second
+     == 0 if the arguments are equal
+     < 0 if the first argument should be placed after the second
+   Complexity O(n)
+   returns the list of removed nodes
+ */
+void * LL_FUNCTION(union)(LL_HEAD head, const LL_CONTEXT o, void * const list, int (*compare)(void *, void *))
+{
+    return LL_PRIVATE(combine)(head, o, list, compare, LL_KEEP_X | LL_KEEP_Y | LL_KEEP_MATCH);
+}
+
+/* intersection of sorted linked list head with "list"
+   only nodes in head equal to a node in list are kept, duplicates included
+   compare must return:
+     > 0 if the first argument should be placed before the second
+     == 0 if the arguments are equal
+     < 0 if the first argument should be placed after the second
+   Complexity O(n)
+   returns the list of removed nodes, including every node of list
+ */
+void * LL_FUNCTION(intersect)(LL_HEAD head, const LL_CONTEXT o, void * const list, int (*compare)(void *, void *))
+{
+    return LL_PRIVATE(combine)(head, o, list, compare, LL_KEEP_MATCH);
+}
+
+/* difference of sorted linked list head and "list"
+   only nodes in head not equal to any node in list are kept, duplicates included
+   compare must return:
+     > 0 if the first argument should be placed before the second
+     == 0 if the arguments are equal
+     < 0 if the first argument should be placed after the second
+   Complexity O(n)
+   returns the list of removed nodes, including every node of list
+ */
+void * LL_FUNCTION(difference)(LL_HEAD head, const LL_CONTEXT o, void * const list, int (*compare)(void *, void *))
+{
+    return LL_PRIVATE(combine)(head, o, list, compare, LL_KEEP_X);
 }
 
 /* executes function fn on each item in the linked list
    Complexity O(n)
  */
-void ll_each(const LL_TYPE head, const size_t o, void (*fn)(void *, void *), void * param)
+void LL_FUNCTION(each)(const LL_HEAD head, const LL_CONTEXT o, void (*fn)(void *, void *), void * param)
 {
     void* x;
-    for(x=*head; x; x = NEXT(x)) fn(x, param);
+    for(x=GET(head); x; x = NEXT(x)) fn(x, param);
 }
 
 /* returns an iterator for this linked list
    Complexity O(1)
  */
-LL_ITERATOR ll_iter(const LL_TYPE head)
+#ifdef LL_ITER_CONTEXT
+LL_ITERATOR LL_FUNCTION(iter)(const LL_HEAD head, const LL_CONTEXT o)
+#else
+LL_ITERATOR LL_FUNCTION(iter)(const LL_HEAD head)
+#endif
 {
-    return (LL_ITERATOR){ *head };
+    return (LL_ITERATOR){ GET(head) };
 }
 
 /* returns the value for the iterator, or NULL if there is no value 
    Complexity O(1)
  */
-void * ll_iter_val(LL_ITERATOR * const it)
+void * LL_FUNCTION(iter_val)(LL_ITERATOR * const it)
 {
     return it->n;
 }
@@ -398,7 +690,7 @@ void * ll_iter_val(LL_ITERATOR * const it)
 /* advances the iterator, or sets it to NULL if this is the end of the list
    Complexity O(1)
  */
-void ll_iter_next(LL_ITERATOR * it, const size_t o)
+void LL_FUNCTION(iter_next)(LL_ITERATOR * it, const LL_CONTEXT o)
 {
     void* x = NEXT(it->n);
     it->n = x;
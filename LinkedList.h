@@ -2,43 +2,140 @@
 #define __LINKED_LIST_H__
 
 #include <stddef.h>
+#include <stdint.h>
+#include "Template.h"
+#include "LinkedListTypes.h"
 
-/* Concatenate preprocessor tokens A and B without expanding macro definitions
-   (however, if invoked from a macro, macro arguments are expanded).
- */
-#define PPCAT_NX(A, B) A ## B
-
-/* Concatenate preprocessor tokens A and B after macro-expanding them.
- */
-#define PPCAT(A, B) PPCAT_NX(A, B)
-
-/* Extract an element of type (member_type) at offset (offset) in the structure pointed to by (ptr)
- */
-#define offsetin(ptr, offset, member_type) *((member_type*)((char*)ptr + offset))
-
-typedef void ** LL_TYPE;
-typedef int (*LL_COMPARE)(void *, void *);
-typedef struct {
-    void * n;
-} LL_ITERATOR;
-
-int ll_length(LL_TYPE head, size_t o);
+size_t ll_length(LL_TYPE head, size_t o);
 void ll_push(LL_TYPE head, size_t o, void * item);
 void * ll_pop(LL_TYPE head, size_t o);
 void ll_append(LL_TYPE head, size_t o, void * item);
 void * ll_deduct(LL_TYPE head, size_t o);
 void * ll_remove(LL_TYPE head, size_t o, void * item);
 void * ll_find(const LL_TYPE head, size_t o, void * item, LL_COMPARE);
+size_t ll_find_many(const LL_TYPE head, size_t o, void * const * keys, size_t m, LL_COMPARE, void ** results);
+size_t ll_find_many_sorted(const LL_TYPE head, size_t o, void * const * keys, size_t m, LL_COMPARE, void ** results);
 void ll_merge(LL_TYPE head, size_t o, void * list, LL_COMPARE);
 void ll_sort(LL_TYPE head, size_t o, LL_COMPARE);
 void ll_each(const LL_TYPE head, size_t o, void (*fn)(void *, void *), void * param);
-void ** _ll_merge2(LL_TYPE head, size_t o, void * list, LL_COMPARE, int n);
+void ** _ll_merge2(LL_TYPE head, size_t o, void * list, LL_COMPARE, size_t n);
 void ll_sort2(LL_TYPE head, size_t o, LL_COMPARE);
+void * ll_unique(LL_TYPE head, size_t o, LL_COMPARE);
+void * ll_union(LL_TYPE head, size_t o, void * list, LL_COMPARE);
+void * ll_intersect(LL_TYPE head, size_t o, void * list, LL_COMPARE);
+void * ll_difference(LL_TYPE head, size_t o, void * list, LL_COMPARE);
 
 LL_ITERATOR ll_iter(const LL_TYPE head);
 void * ll_iter_val(LL_ITERATOR* it);
 void ll_iter_next(LL_ITERATOR* it, size_t o);
 
+/* Self-relative links store the distance in bytes from the link to the item
+   it points to, 0 is used for NULL. A list that only points within a block of
+   memory stays valid when that block is written to disk and mapped back,
+   or mapped by several processes at different addresses.
+ */
+typedef ptrdiff_t LL_REL;
+typedef LL_REL * LL_REL_TYPE;
+
+/* the item the self-relative link points to */
+static inline void * ll_rel_get(const LL_REL * link)
+{
+    return *link ? (char *)link + *link : NULL;
+}
+
+/* make the self-relative link point to item */
+static inline void ll_rel_set(LL_REL * link, const void * item)
+{
+    *link = item ? (const char *)item - (const char *)link : 0;
+}
+
+size_t ll_rel_length(LL_REL_TYPE head, size_t o);
+void ll_rel_push(LL_REL_TYPE head, size_t o, void * item);
+void * ll_rel_pop(LL_REL_TYPE head, size_t o);
+void ll_rel_append(LL_REL_TYPE head, size_t o, void * item);
+void * ll_rel_deduct(LL_REL_TYPE head, size_t o);
+void * ll_rel_remove(LL_REL_TYPE head, size_t o, void * item);
+void * ll_rel_find(const LL_REL_TYPE head, size_t o, void * item, LL_COMPARE);
+size_t ll_rel_find_many(const LL_REL_TYPE head, size_t o, void * const * keys, size_t m, LL_COMPARE, void ** results);
+size_t ll_rel_find_many_sorted(const LL_REL_TYPE head, size_t o, void * const * keys, size_t m, LL_COMPARE, void ** results);
+void ll_rel_merge(LL_REL_TYPE head, size_t o, void * list, LL_COMPARE);
+void ll_rel_sort(LL_REL_TYPE head, size_t o, LL_COMPARE);
+void ll_rel_each(const LL_REL_TYPE head, size_t o, void (*fn)(void *, void *), void * param);
+LL_REL * _ll_rel_merge2(LL_REL_TYPE head, size_t o, void * list, LL_COMPARE, size_t n);
+void ll_rel_sort2(LL_REL_TYPE head, size_t o, LL_COMPARE);
+void * ll_rel_unique(LL_REL_TYPE head, size_t o, LL_COMPARE);
+void * ll_rel_union(LL_REL_TYPE head, size_t o, void * list, LL_COMPARE);
+void * ll_rel_intersect(LL_REL_TYPE head, size_t o, void * list, LL_COMPARE);
+void * ll_rel_difference(LL_REL_TYPE head, size_t o, void * list, LL_COMPARE);
+
+LL_ITERATOR ll_rel_iter(const LL_REL_TYPE head);
+void * ll_rel_iter_val(LL_ITERATOR* it);
+void ll_rel_iter_next(LL_ITERATOR* it, size_t o);
+
+/* a file mapped into memory by ll_rel_load */
+typedef struct {
+    void * base;
+    size_t size;
+    void * handle;
+} LL_MAP;
+
+int ll_rel_save(const char * path, const void * base, size_t size);
+void * ll_rel_load(const char * path, LL_MAP * map);
+void ll_rel_unload(LL_MAP * map);
+
+/* Index links store the position of the item in an array of nodes (the pool)
+   instead of its address, LL_IDX_NULL is used for NULL. A 32-bit index is
+   half the size of a pointer on 64-bit systems, which can shrink each node.
+ */
+typedef uint32_t LL_IDX;
+typedef LL_IDX * LL_IDX_TYPE;
+#define LL_IDX_NULL ((LL_IDX)0xFFFFFFFF)
+
+/* the array of nodes index links refer to */
+typedef struct {
+    void * base;   /* address of the first node */
+    size_t size;   /* size of each node */
+    size_t offset; /* offset where the LL_IDX next element is located */
+} LL_POOL;
+
+/* initialize an LL_POOL for an array of "type" with an LL_IDX "next" element */
+#define LL_POOL_INIT(base, type) { (base), sizeof(type), offsetof(type, next) }
+
+/* the item the index link points to */
+static inline void * ll_idx_get(const LL_POOL * pool, const LL_IDX * link)
+{
+    return *link == LL_IDX_NULL ? NULL : (char *)pool->base + (size_t)*link * pool->size;
+}
+
+/* make the index link point to item */
+static inline void ll_idx_set(const LL_POOL * pool, LL_IDX * link, const void * item)
+{
+    *link = item ? (LL_IDX)(((const char *)item - (const char *)pool->base) / pool->size) : LL_IDX_NULL;
+}
+
+size_t ll_idx_length(LL_IDX_TYPE head, const LL_POOL * o);
+void ll_idx_push(LL_IDX_TYPE head, const LL_POOL * o, void * item);
+void * ll_idx_pop(LL_IDX_TYPE head, const LL_POOL * o);
+void ll_idx_append(LL_IDX_TYPE head, const LL_POOL * o, void * item);
+void * ll_idx_deduct(LL_IDX_TYPE head, const LL_POOL * o);
+void * ll_idx_remove(LL_IDX_TYPE head, const LL_POOL * o, void * item);
+void * ll_idx_find(const LL_IDX_TYPE head, const LL_POOL * o, void * item, LL_COMPARE);
+size_t ll_idx_find_many(const LL_IDX_TYPE head, const LL_POOL * o, void * const * keys, size_t m, LL_COMPARE, void ** results);
+size_t ll_idx_find_many_sorted(const LL_IDX_TYPE head, const LL_POOL * o, void * const * keys, size_t m, LL_COMPARE, void ** results);
+void ll_idx_merge(LL_IDX_TYPE head, const LL_POOL * o, void * list, LL_COMPARE);
+void ll_idx_sort(LL_IDX_TYPE head, const LL_POOL * o, LL_COMPARE);
+void ll_idx_each(const LL_IDX_TYPE head, const LL_POOL * o, void (*fn)(void *, void *), void * param);
+LL_IDX * _ll_idx_merge2(LL_IDX_TYPE head, const LL_POOL * o, void * list, LL_COMPARE, size_t n);
+void ll_idx_sort2(LL_IDX_TYPE head, const LL_POOL * o, LL_COMPARE);
+void * ll_idx_unique(LL_IDX_TYPE head, const LL_POOL * o, LL_COMPARE);
+void * ll_idx_union(LL_IDX_TYPE head, const LL_POOL * o, void * list, LL_COMPARE);
+void * ll_idx_intersect(LL_IDX_TYPE head, const LL_POOL * o, void * list, LL_COMPARE);
+void * ll_idx_difference(LL_IDX_TYPE head, const LL_POOL * o, void * list, LL_COMPARE);
+
+LL_ITERATOR ll_idx_iter(const LL_IDX_TYPE head, const LL_POOL * o);
+void * ll_idx_iter_val(LL_ITERATOR* it);
+void ll_idx_iter_next(LL_ITERATOR* it, const LL_POOL * o);
+
 #endif // !__LINKED_LIST_H__
 
 #if defined(TEMPLATE_PREFIX) && defined(TEMPLATE_STRUCT) && defined(TEMPLATE_STRUCT)
@@ -48,57 +145,78 @@ void ll_iter_next(LL_ITERATOR* it, size_t o);
 #define STRUCT TEMPLATE_STRUCT
 #define OFFSET offsetof(STRUCT, next)
 
+/* define TEMPLATE_RELATIVE when the next element is a LL_REL
+   define TEMPLATE_POOL as the address of the LL_POOL when the next element is a LL_IDX */
+#if defined(TEMPLATE_RELATIVE)
+#define LINK LL_REL
+#define HEAD LL_REL_TYPE
+#define CORE(name) PPCAT(ll_rel_, name)
+#define CORE_PRIVATE(name) PPCAT(_ll_rel_, name)
+#elif defined(TEMPLATE_POOL)
+#undef OFFSET
+#define OFFSET (TEMPLATE_POOL)
+#define LINK LL_IDX
+#define HEAD LL_IDX_TYPE
+#define CORE(name) PPCAT(ll_idx_, name)
+#define CORE_PRIVATE(name) PPCAT(_ll_idx_, name)
+#else
+#define LINK STRUCT *
+#define HEAD LL_TYPE
+#define CORE(name) PPCAT(ll_, name)
+#define CORE_PRIVATE(name) PPCAT(_ll_, name)
+#endif
+
 #define FUNCTION(name) PPCAT(PREFIX, name)
 
 /* determine the length of the linked list
    Complexity O(n)
  */
-static inline int FUNCTION(length)(STRUCT ** head)
+static inline size_t FUNCTION(length)(LINK * head)
 {
-    return ll_length((LL_TYPE)head, OFFSET);
+    return CORE(length)((HEAD)head, OFFSET);
 }
 
 /* push item to the beginning of the linked list
    Complexity O(1)
  */
-static inline void FUNCTION(push)(STRUCT ** head, STRUCT * item)
+static inline void FUNCTION(push)(LINK * head, STRUCT * item)
 {
-    ll_push((LL_TYPE)head, OFFSET, item);
+    CORE(push)((HEAD)head, OFFSET, item);
 }
 
 /* pop item from the beginning of the linked list
    returns the popped item
    Complexity O(1)
  */
-static inline STRUCT * FUNCTION(pop)(STRUCT ** head)
+static inline STRUCT * FUNCTION(pop)(LINK * head)
 {
-    return (STRUCT *)ll_pop((LL_TYPE)head, OFFSET);
+    return (STRUCT *)CORE(pop)((HEAD)head, OFFSET);
 }
 
 /* append item to the end of the linked list
    Complexity O(n)
  */
-static inline void FUNCTION(append)(STRUCT ** head, STRUCT * item)
+static inline void FUNCTION(append)(LINK * head, STRUCT * item)
 {
-    ll_append((LL_TYPE)head, OFFSET, item);
+    CORE(append)((HEAD)head, OFFSET, item);
 }
 
 /* deduct item from the end of the linked list
    returns the deducted item
    Complexity O(n)
  */
-static inline STRUCT * FUNCTION(deduct)(STRUCT ** head)
+static inline STRUCT * FUNCTION(deduct)(LINK * head)
 {
-    return (STRUCT *)ll_deduct((LL_TYPE)head, OFFSET);
+    return (STRUCT *)CORE(deduct)((HEAD)head, OFFSET);
 }
 
 /* remove item from the linked list
    returns the removed item
    Complexity O(n)
  */
-static inline STRUCT * FUNCTION(remove)(STRUCT ** head, STRUCT * item)
+static inline STRUCT * FUNCTION(remove)(LINK * head, STRUCT * item)
 {
-    return (STRUCT *)ll_remove((LL_TYPE)head, OFFSET, item);
+    return (STRUCT *)CORE(remove)((HEAD)head, OFFSET, item);
 }
 
 /* find a match to item in the linked list
@@ -107,9 +225,37 @@ static inline STRUCT * FUNCTION(remove)(STRUCT ** head, STRUCT * item)
    item will be passed to compare as the second argument
    Complexity O(n)
  */
-static inline STRUCT * FUNCTION(find)(STRUCT ** head, void * item, int (*compare)(STRUCT *, void *))
+static inline STRUCT * FUNCTION(find)(LINK * head, void * item, int (*compare)(STRUCT *, void *))
 {
-    return (STRUCT *)ll_find((LL_TYPE)head, OFFSET, item, (LL_COMPARE)compare);
+    return (STRUCT *)CORE(find)((HEAD)head, OFFSET, item, (LL_COMPARE)compare);
+}
+
+/* find a match to each of the m keys in a single pass over the linked list
+   results[i] is set to the first item matching keys[i], or NULL if not found
+   compare must return:
+     == 0 if this is the desired item for the key
+   the key will be passed to compare as the second argument
+   returns the number of keys not found
+   Complexity O(n * m)
+ */
+static inline size_t FUNCTION(find_many)(LINK * head, void * const * keys, size_t m, int (*compare)(STRUCT *, void *), STRUCT ** results)
+{
+    return CORE(find_many)((HEAD)head, OFFSET, keys, m, (LL_COMPARE)compare, (void **)results);
+}
+
+/* find a match to each of the m keys in a sorted linked list, with keys in
+   the same order, stopping after the last key
+   results[i] is set to the first item matching keys[i], or NULL if not found
+   compare must return:
+     > 0 if the item (first argument) is placed before the key (second argument)
+     == 0 if the item has the key
+     < 0 if the item is placed after the key
+   returns the number of keys not found
+   Complexity O(n + m)
+ */
+static inline size_t FUNCTION(find_many_sorted)(LINK * head, void * const * keys, size_t m, int (*compare)(STRUCT *, void *), STRUCT ** results)
+{
+    return CORE(find_many_sorted)((HEAD)head, OFFSET, keys, m, (LL_COMPARE)compare, (void **)results);
 }
 
 /* merge linked list "list" into head
@@ -118,9 +264,9 @@ static inline STRUCT * FUNCTION(find)(STRUCT ** head, void * item, int (*compare
      < 0 if the first argument should be placed after the second
    Complexity O(n)
  */
-static inline void FUNCTION(merge)(STRUCT ** head, STRUCT * list, int (*compare)(STRUCT *, STRUCT *))
+static inline void FUNCTION(merge)(LINK * head, STRUCT * list, int (*compare)(STRUCT *, STRUCT *))
 {
-    ll_merge((LL_TYPE)head, OFFSET, list, (LL_COMPARE)compare);
+    CORE(merge)((HEAD)head, OFFSET, list, (LL_COMPARE)compare);
 }
 
 /* sort linked list
@@ -129,9 +275,9 @@ static inline void FUNCTION(merge)(STRUCT ** head, STRUCT * list, int (*compare)
      < 0 if the first argument should be placed after the second
    Complexity O(n log(n))
  */
-static inline void FUNCTION(sort)(STRUCT ** head, int (*compare)(STRUCT *, STRUCT *))
+static inline void FUNCTION(sort)(LINK * head, int (*compare)(STRUCT *, STRUCT *))
 {
-    ll_sort((LL_TYPE)head, OFFSET, (LL_COMPARE)compare);
+    CORE(sort)((HEAD)head, OFFSET, (LL_COMPARE)compare);
 }
 
 /* merge up to n nodes from "*head" with up to n nodes from "list"
@@ -142,9 +288,9 @@ static inline void FUNCTION(sort)(STRUCT ** head, int (*compare)(STRUCT *, STRUC
    Complexity O(n)
    returns pointer to NEXT pointer at end of merged result
  */
-static inline STRUCT ** FUNCTION(merge2)(STRUCT ** head, STRUCT * list, int (*compare)(STRUCT *, STRUCT *), int n)
+static inline LINK * FUNCTION(merge2)(LINK * head, STRUCT * list, int (*compare)(STRUCT *, STRUCT *), size_t n)
 {
-    return (STRUCT **)_ll_merge2((LL_TYPE)head, OFFSET, list, (LL_COMPARE)compare, n);
+    return (LINK *)CORE_PRIVATE(merge2)((HEAD)head, OFFSET, list, (LL_COMPARE)compare, n);
 }
 
 /* sort linked list
@@ -153,31 +299,89 @@ static inline STRUCT ** FUNCTION(merge2)(STRUCT ** head, STRUCT * list, int (*co
      < 0 if the first argument should be placed after the second
    Complexity O(n log(n))
  */
-static inline void FUNCTION(sort2)(STRUCT ** head, int (*compare)(STRUCT *, STRUCT *))
+static inline void FUNCTION(sort2)(LINK * head, int (*compare)(STRUCT *, STRUCT *))
+{
+    CORE(sort2)((HEAD)head, OFFSET, (LL_COMPARE)compare);
+}
+
+/* remove consecutive equal items from the linked list
+   for a sorted list this leaves only unique items
+   compare must return:
+     == 0 if the arguments are equal
+   Complexity O(n)
+   returns the list of removed items
+ */
+static inline STRUCT * FUNCTION(unique)(LINK * head, int (*compare)(STRUCT *, STRUCT *))
+{
+    return (STRUCT *)CORE(unique)((HEAD)head, OFFSET, (LL_COMPARE)compare);
+}
+
+/* union of sorted linked list "list" into head
+   items in list equal to an item in head are removed, duplicates included
+   compare must return:
+     > 0 if the first argument should be placed before the second
+     == 0 if the arguments are equal
+     < 0 if the first argument should be placed after the second
+   Complexity O(n)
+   returns the list of removed items
+ */
+static inline STRUCT * FUNCTION(union)(LINK * head, STRUCT * list, int (*compare)(STRUCT *, STRUCT *))
+{
+    return (STRUCT *)CORE(union)((HEAD)head, OFFSET, list, (LL_COMPARE)compare);
+}
+
+/* intersection of sorted linked list head with "list"
+   only items in head equal to an item in list are kept, duplicates included
+   compare must return:
+     > 0 if the first argument should be placed before the second
+     == 0 if the arguments are equal
+     < 0 if the first argument should be placed after the second
+   Complexity O(n)
+   returns the list of removed items, including every item of list
+ */
+static inline STRUCT * FUNCTION(intersect)(LINK * head, STRUCT * list, int (*compare)(STRUCT *, STRUCT *))
+{
+    return (STRUCT *)CORE(intersect)((HEAD)head, OFFSET, list, (LL_COMPARE)compare);
+}
+
+/* difference of sorted linked list head and "list"
+   only items in head not equal to any item in list are kept, duplicates included
+   compare must return:
+     > 0 if the first argument should be placed before the second
+     == 0 if the arguments are equal
+     < 0 if the first argument should be placed after the second
+   Complexity O(n)
+   returns the list of removed items, including every item of list
+ */
+static inline STRUCT * FUNCTION(difference)(LINK * head, STRUCT * list, int (*compare)(STRUCT *, STRUCT *))
 {
-    ll_sort2((LL_TYPE)head, OFFSET, (LL_COMPARE)compare);
+    return (STRUCT *)CORE(difference)((HEAD)head, OFFSET, list, (LL_COMPARE)compare);
 }
 
-static inline void FUNCTION(each)(STRUCT ** head, void (*fn)(STRUCT *, void *), void * param)
+static inline void FUNCTION(each)(LINK * head, void (*fn)(STRUCT *, void *), void * param)
 {
     /* The below cast is technically undefined behavior...
      * let me know if you find a system it fails in */
-    ll_each((LL_TYPE)head, OFFSET, (void (*)(void *, void *))fn, param);
+    CORE(each)((HEAD)head, OFFSET, (void (*)(void *, void *))fn, param);
 }
 
-static inline LL_ITERATOR FUNCTION(iter)(STRUCT** head)
+static inline LL_ITERATOR FUNCTION(iter)(LINK * head)
 {
-    return ll_iter((LL_TYPE)head);
+#if defined(TEMPLATE_POOL)
+    return CORE(iter)((HEAD)head, OFFSET);
+#else
+    return CORE(iter)((HEAD)head);
+#endif
 }
 
 static inline STRUCT * FUNCTION(iter_val)(LL_ITERATOR* it)
 {
-    return ll_iter_val(it);
+    return CORE(iter_val)(it);
 }
 
 static inline void FUNCTION(iter_next)(LL_ITERATOR* it)
 {
-    ll_iter_next(it, OFFSET);
+    CORE(iter_next)(it, OFFSET);
 }
 
 #ifndef for_each
@@ -193,10 +397,16 @@ static inline void FUNCTION(iter_next)(LL_ITERATOR* it)
 #undef PREFIX
 #undef STRUCT
 #undef OFFSET
+#undef LINK
+#undef HEAD
+#undef CORE
+#undef CORE_PRIVATE
 
 #undef TEMPLATE_PREFIX 
 #undef TEMPLATE_STRUCT
 #undef TEMPLATE_STRUCT
+#undef TEMPLATE_RELATIVE
+#undef TEMPLATE_POOL
 
 #undef FUNCTION
 
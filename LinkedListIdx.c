@@ -0,0 +1,13 @@
+/* Index link mode, generates the ll_idx_* family of functions
+   from the same algorithms as the ll_* family
+   "o" is the LL_POOL the nodes of the list are allocated from
+ */
+#define LL_NAME ll_idx
+#define LL_LINK LL_IDX
+#define LL_HEAD LL_IDX_TYPE
+#define LL_CONTEXT LL_POOL *
+#define LL_OFFSET(o) ((o)->offset)
+#define LL_ITER_CONTEXT
+#define GET(l) ll_idx_get(o, l)
+#define SET(l, v) ll_idx_set(o, l, v)
+#include "LinkedList.c"
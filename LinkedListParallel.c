@@ -0,0 +1,130 @@
+#include <stdlib.h>
+#include <string.h>
+#include "LinkedList.h"
+#include "LinkedListParallel.h"
+
+/* number of items in each task given to the pool */
+#ifndef LL_PARALLEL_CHUNK
+#define LL_PARALLEL_CHUNK 1024
+#endif
+
+/* assumes variable "o" is the offset where the void * NEXT element is located */
+#define NEXT(x) offsetin(x, o, void *)
+
+/* what to do with every item, shared by all chunks */
+typedef struct {
+    size_t o;
+    void (*each)(void *, void *);         /* set by ll_each_parallel */
+    void (*fn)(void *, void *, void *);   /* set by ll_reduce_parallel */
+    void * param;
+} LL_JOB;
+
+/* a run of consecutive items processed by one task */
+typedef struct LL_CHUNK {
+    struct LL_CHUNK * next;
+    const LL_JOB * job;
+    void * first;
+    size_t count;
+    max_align_t acc[]; /* accumulator for ll_reduce_parallel */
+} LL_CHUNK;
+
+static void ll_run_chunk(void * const arg)
+{
+    LL_CHUNK * c = arg;
+    const LL_JOB * job = c->job;
+    const size_t o = job->o;
+    void * x = c->first;
+    size_t i;
+
+    if(job->each)
+    {
+        for(i=0; i < c->count; i++, x = NEXT(x))
+            job->each(x, job->param);
+    }
+    else
+    {
+        for(i=0; i < c->count; i++, x = NEXT(x))
+            job->fn(x, c->acc, job->param);
+    }
+}
+
+/* walk the list once, cutting it into chunks which are run on the pool as
+   soon as they are cut, then combine the accumulator of each chunk in order
+   if memory for a chunk can't be allocated the rest of the list is
+   processed on the calling thread
+ */
+static void ll_parallel(const LL_TYPE head, const LL_JOB * const job,
+                        void (*combine)(void *, void *, void *), void * const result, const size_t size,
+                        THREAD_POOL * const pool)
+{
+    const size_t o = job->o;
+    LL_CHUNK * chunks = NULL, ** tail = &chunks, * c;
+    TP_GROUP group = { 0 };
+    void * x = *head;
+
+    while(pool && x)
+    {
+        c = malloc(sizeof(LL_CHUNK) + size);
+        if(c == NULL) break;
+
+        c->next = NULL;
+        c->job = job;
+        c->first = x;
+        memset(c->acc, 0, size);
+
+        /* find the first item of the next chunk */
+        for(c->count=0; x && c->count < LL_PARALLEL_CHUNK; c->count++)
+            x = NEXT(x);
+
+        *tail = c;
+        tail = &c->next;
+
+        if(tp_submit(pool, &group, ll_run_chunk, c) != 0) ll_run_chunk(c);
+    }
+
+    if(pool) tp_wait(pool, &group);
+
+    /* combine in list order and free the chunks */
+    while(chunks)
+    {
+        c = chunks;
+        chunks = c->next;
+        if(combine) combine(result, c->acc, job->param);
+        free(c);
+    }
+
+    /* anything left is done serially, accumulating straight into result */
+    for(; x; x = NEXT(x))
+    {
+        if(job->each) job->each(x, job->param);
+        else job->fn(x, result, job->param);
+    }
+}
+
+/* executes function fn on each item in the linked list using the threads in pool
+   the calling thread helps and returns once fn has finished for every item
+   fn may be called for several items at the same time, and must not change the links
+   if pool is NULL this is the same as ll_each
+   Complexity O(n / threads)
+ */
+void ll_each_parallel(const LL_TYPE head, const size_t o, void (*fn)(void *, void *), void * const param, THREAD_POOL * const pool)
+{
+    LL_JOB job = { o, fn, NULL, param };
+    ll_parallel(head, &job, NULL, NULL, 0, pool);
+}
+
+/* executes function fn on each item in the linked list using the threads in pool
+   fn receives the item, an accumulator of "size" bytes and param
+   each chunk of items starts with a zeroed accumulator, when all chunks are
+   done combine receives result, the accumulator of a chunk and param,
+   for each chunk in list order
+   if pool is NULL fn accumulates straight into result and combine is not called
+   Complexity O(n / threads)
+ */
+void ll_reduce_parallel(const LL_TYPE head, const size_t o, void (*fn)(void *, void *, void *), void * const param,
+                        void (*combine)(void *, void *, void *), void * const result, const size_t size,
+                        THREAD_POOL * const pool)
+{
+    LL_JOB job = { o, NULL, fn, param };
+    ll_parallel(head, &job, combine, result, size, pool);
+}
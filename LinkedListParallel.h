@@ -0,0 +1,61 @@
+#ifndef __LINKED_LIST_PARALLEL_H__
+#define __LINKED_LIST_PARALLEL_H__
+
+#include <stddef.h>
+#include "Template.h"
+#include "LinkedListTypes.h"
+#include "ThreadPool.h"
+
+/* Runs a function on every item of a plain linked list with the threads of a
+   THREAD_POOL. The list is cut into chunks of LL_PARALLEL_CHUNK items and each
+   chunk is one task for the pool. Kept apart from LinkedList.h so single
+   threaded users of the list don't depend on the pool.
+ */
+
+void ll_each_parallel(const LL_TYPE head, size_t o, void (*fn)(void *, void *), void * param, THREAD_POOL * pool);
+void ll_reduce_parallel(const LL_TYPE head, size_t o, void (*fn)(void *, void *, void *), void * param,
+                        void (*combine)(void *, void *, void *), void * result, size_t size, THREAD_POOL * pool);
+
+#endif // !__LINKED_LIST_PARALLEL_H__
+
+#if defined(TEMPLATE_PREFIX) && defined(TEMPLATE_STRUCT)
+
+/*shorter versions of the template definitions*/
+#define PREFIX PPCAT(TEMPLATE_PREFIX, _)
+#define STRUCT TEMPLATE_STRUCT
+#define OFFSET offsetof(STRUCT, next)
+
+#define FUNCTION(name) PPCAT(PREFIX, name)
+
+/* executes function fn on each item in the linked list using the threads in pool
+   fn may be called for several items at the same time
+   Complexity O(n / threads)
+ */
+static inline void FUNCTION(each_parallel)(STRUCT ** head, void (*fn)(STRUCT *, void *), void * param, THREAD_POOL * pool)
+{
+    ll_each_parallel((LL_TYPE)head, OFFSET, (void (*)(void *, void *))fn, param, pool);
+}
+
+/* executes function fn on each item in the linked list using the threads in pool
+   fn accumulates into a zeroed accumulator of "size" bytes for each chunk of items,
+   then combine merges the accumulator of each chunk into result, in list order
+   Complexity O(n / threads)
+ */
+static inline void FUNCTION(reduce_parallel)(STRUCT ** head, void (*fn)(STRUCT *, void *, void *), void * param,
+                                             void (*combine)(void *, void *, void *), void * result, size_t size,
+                                             THREAD_POOL * pool)
+{
+    ll_reduce_parallel((LL_TYPE)head, OFFSET, (void (*)(void *, void *, void *))fn, param, combine, result, size, pool);
+}
+
+/* un-define all the template magic */
+#undef PREFIX
+#undef STRUCT
+#undef OFFSET
+
+#undef TEMPLATE_PREFIX
+#undef TEMPLATE_STRUCT
+
+#undef FUNCTION
+
+#endif // TEMPLATE
@@ -0,0 +1,111 @@
+/* Self-relative link mode, generates the ll_rel_* family of functions
+   from the same algorithms as the ll_* family
+ */
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define LL_NAME ll_rel
+#define LL_LINK LL_REL
+#define LL_HEAD LL_REL_TYPE
+#define LL_CONTEXT size_t
+#define LL_OFFSET(o) (o)
+#define GET(l) ll_rel_get(l)
+#define SET(l, v) ll_rel_set(l, v)
+#include "LinkedList.c"
+
+/* write size bytes starting at base to the file at path
+   every self-relative list, including its head, must be within this block
+   returns 0 on success
+ */
+int ll_rel_save(const char * const path, const void * const base, const size_t size)
+{
+    FILE * f;
+    size_t written;
+
+    f = fopen(path, "wb");
+    if(f == NULL) return -1;
+    written = fwrite(base, 1, size, f);
+    if(fclose(f) != 0 || written != size) return -1;
+    return 0;
+}
+
+/* map the file at path into memory, changes to the mapping are written
+   back to the file and are visible to other processes mapping the same file
+   no deserialization is needed, the lists can be iterated as soon as this returns
+   returns the base address of the mapping, or NULL on failure
+ */
+void * ll_rel_load(const char * const path, LL_MAP * const map)
+{
+#ifdef _WIN32
+    HANDLE file, mapping;
+    LARGE_INTEGER size;
+
+    file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                       NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE) return NULL;
+    if(!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, 0, 0, NULL);
+    CloseHandle(file); /* the mapping keeps the file open */
+    if(mapping == NULL) return NULL;
+
+    map->base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if(map->base == NULL)
+    {
+        CloseHandle(mapping);
+        return NULL;
+    }
+    map->size = (size_t)size.QuadPart;
+    map->handle = mapping;
+#else
+    int fd;
+    struct stat st;
+    void * base;
+
+    fd = open(path, O_RDWR);
+    if(fd < 0) return NULL;
+    if(fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); /* the mapping keeps the file open */
+    if(base == MAP_FAILED) return NULL;
+
+    map->base = base;
+    map->size = (size_t)st.st_size;
+    map->handle = NULL;
+#endif
+    return map->base;
+}
+
+/* unmap a file mapped by ll_rel_load
+   any pointers into the mapping are invalid after this returns
+ */
+void ll_rel_unload(LL_MAP * const map)
+{
+    if(map->base == NULL) return;
+#ifdef _WIN32
+    UnmapViewOfFile(map->base);
+    CloseHandle(map->handle);
+#else
+    munmap(map->base, map->size);
+#endif
+    map->base = NULL;
+    map->size = 0;
+    map->handle = NULL;
+}
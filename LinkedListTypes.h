@@ -0,0 +1,14 @@
+#ifndef __LINKED_LIST_TYPES_H__
+#define __LINKED_LIST_TYPES_H__
+
+/* Types shared by every list, kept apart from LinkedList.h so other
+   headers can use them without generating a list template
+ */
+
+typedef void ** LL_TYPE;
+typedef int (*LL_COMPARE)(void *, void *);
+typedef struct {
+    void * n;
+} LL_ITERATOR;
+
+#endif // !__LINKED_LIST_TYPES_H__
@@ -0,0 +1,235 @@
+#include <stdlib.h>
+#include "LinkedList.h"
+#include "LruCache.h"
+
+/* assumes variable "o" is the offset where the LRU_LINK element is located */
+#define LINK(x) (&offsetin(x, o, LRU_LINK))
+
+struct LRU_CACHE {
+    void ** buckets;    /* heads of the hash chains, linked through hnext */
+    size_t mask;        /* number of buckets - 1, a power of 2 - 1 */
+    void * newest;
+    void * oldest;
+    size_t count;
+    size_t capacity;
+    size_t o;           /* offset of the LRU_LINK in each item */
+    size_t (*hash)(void * key);
+    int (*compare)(void * item, void * key);
+    void (*evict)(void * item, void * param);
+    void * param;
+};
+
+/* what ll_find is given to look for in a hash chain */
+typedef struct {
+    const LRU_CACHE * cache;
+    void * key;
+    size_t hash;
+} LRU_PROBE;
+
+/* returns == 0 if x has the key of probe, comparing the stored hash first */
+static int lru_match(void * x, void * probe)
+{
+    const LRU_PROBE * p = probe;
+    const size_t o = p->cache->o;
+
+    if(LINK(x)->hash != p->hash) return 1;
+    return p->cache->compare(x, p->key);
+}
+
+/* the hash chain that an item with hash h belongs to */
+static void ** lru_bucket(const LRU_CACHE * const cache, const size_t h)
+{
+    return &cache->buckets[h & cache->mask];
+}
+
+/* search the hash chain of h for the item with key
+   returns the item, or NULL if not cached
+ */
+static void * lru_find(const LRU_CACHE * const cache, void * const key, const size_t h)
+{
+    LRU_PROBE probe;
+
+    probe.cache = cache;
+    probe.key = key;
+    probe.hash = h;
+    return ll_find(lru_bucket(cache, h), cache->o + offsetof(LRU_LINK, hnext), &probe, lru_match);
+}
+
+/* unlink item from the recency list */
+static void lru_unlink(LRU_CACHE * const cache, void * const item)
+{
+    const size_t o = cache->o;
+    LRU_LINK * const l = LINK(item);
+
+    if(l->newer) LINK(l->newer)->older = l->older;
+    else cache->newest = l->older;
+    if(l->older) LINK(l->older)->newer = l->newer;
+    else cache->oldest = l->newer;
+}
+
+/* link item into the recency list as the newest */
+static void lru_link(LRU_CACHE * const cache, void * const item)
+{
+    const size_t o = cache->o;
+    LRU_LINK * const l = LINK(item);
+
+    l->newer = NULL;
+    l->older = cache->newest;
+    if(cache->newest) LINK(cache->newest)->newer = item;
+    else cache->oldest = item;
+    cache->newest = item;
+}
+
+/* create a cache for items with an LRU_LINK at offset o, holding up to capacity items
+   returns the cache, or NULL if out of memory or capacity is 0
+ */
+LRU_CACHE * lru_create(const size_t o, const size_t capacity, size_t (*hash)(void *), int (*compare)(void *, void *),
+    void (*evict)(void *, void *), void * const param)
+{
+    LRU_CACHE * cache;
+    size_t buckets = 1;
+
+    if(capacity == 0 || hash == NULL || compare == NULL) return NULL;
+
+    /* at least one bucket per item keeps the chains short */
+    while(buckets < capacity) buckets *= 2;
+
+    cache = malloc(sizeof(LRU_CACHE));
+    if(cache == NULL) return NULL;
+    cache->buckets = calloc(buckets, sizeof(void *));
+    if(cache->buckets == NULL)
+    {
+        free(cache);
+        return NULL;
+    }
+
+    cache->mask = buckets - 1;
+    cache->newest = cache->oldest = NULL;
+    cache->count = 0;
+    cache->capacity = capacity;
+    cache->o = o;
+    cache->hash = hash;
+    cache->compare = compare;
+    cache->evict = evict;
+    cache->param = param;
+    return cache;
+}
+
+/* evict every item, oldest first, then free the cache */
+void lru_destroy(LRU_CACHE * const cache)
+{
+    if(cache == NULL) return;
+
+    while(lru_evict(cache))
+        ;
+    free(cache->buckets);
+    free(cache);
+}
+
+size_t lru_count(const LRU_CACHE * const cache)
+{
+    return cache->count;
+}
+
+/* find the item with key without changing its age
+   returns the item, or NULL if not cached
+   Complexity O(1) average
+ */
+void * lru_peek(const LRU_CACHE * const cache, void * const key)
+{
+    return lru_find(cache, key, cache->hash(key));
+}
+
+/* find the item with key and make it the newest
+   returns the item, or NULL if not cached
+   Complexity O(1) average
+ */
+void * lru_get(LRU_CACHE * const cache, void * const key)
+{
+    void * const item = lru_peek(cache, key);
+
+    if(item) lru_touch(cache, item);
+    return item;
+}
+
+/* make a cached item the newest
+   Complexity O(1)
+ */
+void lru_touch(LRU_CACHE * const cache, void * const item)
+{
+    if(cache->newest == item) return;
+    lru_unlink(cache, item);
+    lru_link(cache, item);
+}
+
+/* remove a cached item without calling evict
+   returns the removed item
+   Complexity O(1) average
+ */
+void * lru_remove(LRU_CACHE * const cache, void * const item)
+{
+    const size_t o = cache->o;
+
+    if(item == NULL) return NULL;
+
+    ll_remove(lru_bucket(cache, LINK(item)->hash), o + offsetof(LRU_LINK, hnext), item);
+    lru_unlink(cache, item);
+    cache->count--;
+    return item;
+}
+
+/* returns the item that would be evicted next, or NULL if empty
+   Complexity O(1)
+ */
+void * lru_oldest(const LRU_CACHE * const cache)
+{
+    return cache->oldest;
+}
+
+/* remove the oldest item and pass it to evict
+   returns 1 if an item was evicted, 0 if the cache was empty
+   Complexity O(1) average
+ */
+int lru_evict(LRU_CACHE * const cache)
+{
+    void * const item = lru_remove(cache, cache->oldest);
+
+    if(item == NULL) return 0;
+    if(cache->evict) cache->evict(item, cache->param);
+    return 1;
+}
+
+/* add item with key as the newest item
+   another item already cached with the same key is evicted, as is the oldest
+   item if the cache is over capacity
+   an item that is already cached, under key or any other key, is not
+   evicted, it is moved to key and made the newest
+   Complexity O(1) average
+ */
+void lru_put(LRU_CACHE * const cache, void * const item, void * const key)
+{
+    const size_t o = cache->o;
+    const size_t h = cache->hash(key);
+    void * old;
+
+    /* take item out if it is cached, its stored hash gives the bucket it is in */
+    if(ll_remove(lru_bucket(cache, LINK(item)->hash), o + offsetof(LRU_LINK, hnext), item))
+    {
+        lru_unlink(cache, item);
+        cache->count--;
+    }
+
+    old = lru_find(cache, key, h);
+    if(old)
+    {
+        lru_remove(cache, old);
+        if(cache->evict) cache->evict(old, cache->param);
+    }
+
+    LINK(item)->hash = h;
+    ll_push(lru_bucket(cache, h), o + offsetof(LRU_LINK, hnext), item);
+    lru_link(cache, item);
+    cache->count++;
+
+    if(cache->count > cache->capacity) lru_evict(cache);
+}
@@ -0,0 +1,150 @@
+#ifndef __LRU_CACHE_H__
+#define __LRU_CACHE_H__
+
+#include <stddef.h>
+#include "Template.h"
+
+/* A cache that keeps at most capacity items and evicts the least recently
+   used one when full. Each item holds an intrusive LRU_LINK named lru:
+    * newer, older: the doubly linked recency list, newest to oldest
+    * hnext: the next item in the same hash bucket
+    * hash:  the hash of the key of the item, so it never has to be rehashed
+   get, put, touch, remove and evict are all O(1) on average.
+ */
+
+typedef struct LRU_LINK {
+    void * newer;
+    void * older;
+    void * hnext;
+    size_t hash;
+} LRU_LINK;
+
+typedef struct LRU_CACHE LRU_CACHE;
+
+LRU_CACHE * lru_create(size_t o, size_t capacity, size_t (*hash)(void *), int (*compare)(void *, void *),
+    void (*evict)(void *, void *), void * param);
+void lru_destroy(LRU_CACHE * cache);
+size_t lru_count(const LRU_CACHE * cache);
+void * lru_get(LRU_CACHE * cache, void * key);
+void * lru_peek(const LRU_CACHE * cache, void * key);
+void lru_put(LRU_CACHE * cache, void * item, void * key);
+void lru_touch(LRU_CACHE * cache, void * item);
+void * lru_remove(LRU_CACHE * cache, void * item);
+void * lru_oldest(const LRU_CACHE * cache);
+int lru_evict(LRU_CACHE * cache);
+
+#endif // !__LRU_CACHE_H__
+
+#if defined(TEMPLATE_PREFIX) && defined(TEMPLATE_STRUCT)
+
+/*shorter versions of the template definitions*/
+#define PREFIX PPCAT(TEMPLATE_PREFIX, _)
+#define STRUCT TEMPLATE_STRUCT
+#define OFFSET offsetof(STRUCT, lru)
+
+#define FUNCTION(name) PPCAT(PREFIX, name)
+
+/* create a cache holding up to capacity items
+   hash returns the hash of a key
+   compare must return:
+     == 0 if the item (first argument) has the key (second argument)
+   evict is called with every item the cache drops by itself, and param
+   returns the cache, or NULL if out of memory
+ */
+static inline LRU_CACHE * FUNCTION(create)(size_t capacity, size_t (*hash)(void *), int (*compare)(STRUCT *, void *),
+    void (*evict)(STRUCT *, void *), void * param)
+{
+    return lru_create(OFFSET, capacity, hash, (int (*)(void *, void *))compare, (void (*)(void *, void *))evict, param);
+}
+
+/* find the item with key and make it the newest
+   returns the item, or NULL if not cached
+   Complexity O(1) average
+ */
+static inline STRUCT * FUNCTION(get)(LRU_CACHE * cache, void * key)
+{
+    return (STRUCT *)lru_get(cache, key);
+}
+
+/* find the item with key without changing its age
+   returns the item, or NULL if not cached
+   Complexity O(1) average
+ */
+static inline STRUCT * FUNCTION(peek)(const LRU_CACHE * cache, void * key)
+{
+    return (STRUCT *)lru_peek(cache, key);
+}
+
+/* add item with key as the newest item
+   another item already cached with the same key is evicted, as is the oldest
+   item if the cache is over capacity
+   an item that is already cached, under key or any other key, is not
+   evicted, it is moved to key and made the newest
+   Complexity O(1) average
+ */
+static inline void FUNCTION(put)(LRU_CACHE * cache, STRUCT * item, void * key)
+{
+    lru_put(cache, item, key);
+}
+
+/* make a cached item the newest
+   Complexity O(1)
+ */
+static inline void FUNCTION(touch)(LRU_CACHE * cache, STRUCT * item)
+{
+    lru_touch(cache, item);
+}
+
+/* remove a cached item without calling evict
+   returns the removed item
+   Complexity O(1) average
+ */
+static inline STRUCT * FUNCTION(remove)(LRU_CACHE * cache, STRUCT * item)
+{
+    return (STRUCT *)lru_remove(cache, item);
+}
+
+/* returns the item that would be evicted next, or NULL if empty
+   Complexity O(1)
+ */
+static inline STRUCT * FUNCTION(oldest)(const LRU_CACHE * cache)
+{
+    return (STRUCT *)lru_oldest(cache);
+}
+
+/* remove the oldest item and pass it to evict
+   returns 1 if an item was evicted, 0 if the cache was empty
+   Complexity O(1) average
+ */
+static inline int FUNCTION(evict)(LRU_CACHE * cache)
+{
+    return lru_evict(cache);
+}
+
+/* returns the number of cached items
+   Complexity O(1)
+ */
+static inline size_t FUNCTION(count)(const LRU_CACHE * cache)
+{
+    return lru_count(cache);
+}
+
+/* evict every item, oldest first, then free the cache
+   Complexity O(n)
+ */
+static inline void FUNCTION(destroy)(LRU_CACHE * cache)
+{
+    lru_destroy(cache);
+}
+
+/* un-define all the template magic */
+#undef PREFIX
+#undef STRUCT
+#undef OFFSET
+
+#undef TEMPLATE_PREFIX
+#undef TEMPLATE_STRUCT
+
+#undef FUNCTION
+
+#endif // TEMPLATE
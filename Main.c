@@ -1,7 +1,25 @@
 #include <stdio.h>
 
 void list_test(void);
+void heap_test(void);
+void relative_test(void);
+void index_test(void);
+void set_test(void);
+void set_modes_test(void);
+void parallel_test(void);
+void rcu_test(void);
+void big_sort_test(void);
+void lru_test(void);
+void timer_test(void);
+void find_many_test(void);
 void run_demo(void);
+void bench_ingest(void);
+void bench_each_parallel(void);
+void bench_rcu_readers(void);
+void bench_sort_scale(void);
+void bench_message_cache(void);
+void bench_timeouts(void);
+void bench_find_many(void);
 
 int main(int argc, char **argv)
 {
@@ -11,6 +29,24 @@ int main(int argc, char **argv)
 
 	run_demo();
 	//list_test();
+	//heap_test();
+	//relative_test();
+	//index_test();
+	//set_test();
+	//set_modes_test();
+	//parallel_test();
+	//rcu_test();
+	//big_sort_test();
+	//lru_test();
+	//timer_test();
+	//find_many_test();
+	//bench_ingest();
+	//bench_each_parallel();
+	//bench_rcu_readers();
+	//bench_sort_scale();
+	//bench_message_cache();
+	//bench_timeouts();
+	//bench_find_many();
 
 	printf("Press any Key\r\n");
 	c = getchar();
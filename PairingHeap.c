@@ -0,0 +1,163 @@
+#include "PairingHeap.h"
+
+/* assumes variables "o", "c" and "p" are the offsets where the void * NEXT,
+   CHILD and PREV elements are located */
+#define NEXT(x) offsetin(x, o, void *)
+#define CHILD(x) offsetin(x, c, void *)
+#define PREV(x) offsetin(x, p, void *)
+
+/* link two heap roots x and y into a single heap
+   the root placed after the other becomes the first child of the other
+   Complexity O(1)
+   returns the root of the linked heap
+ */
+static void * _ph_link(const size_t o, const size_t c, const size_t p, void * x, void * y, int (*compare)(void *, void *))
+{
+    void * t;
+
+    if(x == NULL) return y;
+    if(y == NULL) return x;
+
+    /* make x the root that is placed first */
+    if(compare(x, y) < 0)
+    {
+        t = x;
+        x = y;
+        y = t;
+    }
+
+    /* y becomes the first child of x */
+    NEXT(y) = CHILD(x);
+    if(CHILD(x)) PREV(CHILD(x)) = y;
+    PREV(y) = x;
+    CHILD(x) = y;
+
+    NEXT(x) = NULL;
+    PREV(x) = NULL;
+    return x;
+}
+
+/* detach item, and all of its children, from its parent and siblings
+   item must not be the root of the heap
+   Complexity O(1)
+ */
+static void _ph_cut(const size_t o, const size_t c, const size_t p, void * const item)
+{
+    void * prev = PREV(item);
+
+    /* prev is either the parent or the previous sibling */
+    if(CHILD(prev) == item) CHILD(prev) = NEXT(item);
+    else NEXT(prev) = NEXT(item);
+    if(NEXT(item)) PREV(NEXT(item)) = prev;
+
+    NEXT(item) = NULL;
+    PREV(item) = NULL;
+}
+
+/* combine all children of a detached node into a single heap
+   using the standard two pass pairing:
+    * left to right, link children in pairs
+    * right to left, link each pair into the accumulated result
+   Complexity O(log(n)) amortized
+   returns the root of the combined heap
+ */
+static void * _ph_combine(const size_t o, const size_t c, const size_t p, void * x, int (*compare)(void *, void *))
+{
+    void * a, * b, * pairs = NULL;
+
+    /* first pass, pairs are pushed to a stack threaded through NEXT
+       so the second pass visits them right to left */
+    while(x)
+    {
+        a = x;
+        b = NEXT(a);
+        x = b ? NEXT(b) : NULL;
+
+        a = _ph_link(o, c, p, a, b, compare);
+        NEXT(a) = pairs;
+        pairs = a;
+    }
+
+    /* second pass */
+    x = NULL;
+    while(pairs)
+    {
+        a = pairs;
+        pairs = NEXT(a);
+        NEXT(a) = NULL;
+        PREV(a) = NULL;
+        x = _ph_link(o, c, p, a, x, compare);
+    }
+
+    return x;
+}
+
+/* push item into the heap
+   compare must return:
+     >= 0 if the first argument should be placed before the second
+     < 0 if the first argument should be placed after the second
+   Complexity O(1)
+ */
+void ph_push(PH_TYPE head, const size_t o, const size_t c, const size_t p, void * const item, int (*compare)(void *, void *))
+{
+    NEXT(item) = NULL;
+    CHILD(item) = NULL;
+    PREV(item) = NULL;
+    *head = _ph_link(o, c, p, *head, item, compare);
+}
+
+/* pop the first item from the heap
+   returns the popped item
+   Complexity O(log(n)) amortized
+ */
+void * ph_pop(PH_TYPE head, const size_t o, const size_t c, const size_t p, int (*compare)(void *, void *))
+{
+    void * x;
+    x = *head;
+    if(x != NULL) {
+        *head = _ph_combine(o, c, p, CHILD(x), compare);
+        CHILD(x) = NULL;
+    }
+    return x;
+}
+
+/* meld heap "heap" into head
+   Complexity O(1)
+ */
+void ph_meld(PH_TYPE head, const size_t o, const size_t c, const size_t p, void * const heap, int (*compare)(void *, void *))
+{
+    *head = _ph_link(o, c, p, *head, heap, compare);
+}
+
+/* restore the heap after the key of item was changed so that it
+   is placed earlier than before
+   Complexity O(1)
+ */
+void ph_decrease(PH_TYPE head, const size_t o, const size_t c, const size_t p, void * const item, int (*compare)(void *, void *))
+{
+    /* the root has no parent to violate */
+    if(item == *head) return;
+
+    /* the sub-heap of item is still valid, re-link it with the root */
+    _ph_cut(o, c, p, item);
+    *head = _ph_link(o, c, p, *head, item, compare);
+}
+
+/* remove item from the heap
+   returns the removed item
+   Complexity O(log(n)) amortized
+ */
+void * ph_remove(PH_TYPE head, const size_t o, const size_t c, const size_t p, void * const item, int (*compare)(void *, void *))
+{
+    void * x;
+    if(item == NULL || *head == NULL) return NULL;
+
+    if(item == *head) return ph_pop(head, o, c, p, compare);
+
+    /* detach item, then give its children back to the heap */
+    _ph_cut(o, c, p, item);
+    x = _ph_combine(o, c, p, CHILD(item), compare);
+    CHILD(item) = NULL;
+    *head = _ph_link(o, c, p, *head, x, compare);
+    return item;
+}
@@ -0,0 +1,115 @@
+#ifndef __PAIRING_HEAP_H__
+#define __PAIRING_HEAP_H__
+
+#include <stddef.h>
+#include "Template.h"
+#include "LinkedListTypes.h"
+
+/* A pairing heap is a multi-way tree where every node is placed before all
+   of its children. Each node holds three intrusive links:
+    * next:  the next sibling (the node to the right)
+    * child: the first (left most) child
+    * prev:  the previous sibling, or the parent for a first child
+   The root of the heap has no siblings, so next and prev are NULL.
+ */
+
+typedef void ** PH_TYPE;
+
+void ph_push(PH_TYPE head, size_t o, size_t c, size_t p, void * item, LL_COMPARE);
+void * ph_pop(PH_TYPE head, size_t o, size_t c, size_t p, LL_COMPARE);
+void ph_meld(PH_TYPE head, size_t o, size_t c, size_t p, void * heap, LL_COMPARE);
+void ph_decrease(PH_TYPE head, size_t o, size_t c, size_t p, void * item, LL_COMPARE);
+void * ph_remove(PH_TYPE head, size_t o, size_t c, size_t p, void * item, LL_COMPARE);
+
+#endif // !__PAIRING_HEAP_H__
+
+#if defined(TEMPLATE_PREFIX) && defined(TEMPLATE_STRUCT)
+
+/*shorter versions of the template definitions*/
+#define PREFIX PPCAT(TEMPLATE_PREFIX, _)
+#define STRUCT TEMPLATE_STRUCT
+#define OFFSET offsetof(STRUCT, next)
+#define CHILD offsetof(STRUCT, child)
+#define PARENT offsetof(STRUCT, prev)
+
+#define FUNCTION(name) PPCAT(PREFIX, name)
+
+/* return the first item of the heap without removing it
+   Complexity O(1)
+ */
+static inline STRUCT * FUNCTION(peek)(STRUCT ** head)
+{
+    return *head;
+}
+
+/* push item into the heap
+   compare must return:
+     >= 0 if the first argument should be placed before the second
+     < 0 if the first argument should be placed after the second
+   Complexity O(1)
+ */
+static inline void FUNCTION(push)(STRUCT ** head, STRUCT * item, int (*compare)(STRUCT *, STRUCT *))
+{
+    ph_push((PH_TYPE)head, OFFSET, CHILD, PARENT, item, (LL_COMPARE)compare);
+}
+
+/* pop the first item from the heap
+   returns the popped item
+   compare must return:
+     >= 0 if the first argument should be placed before the second
+     < 0 if the first argument should be placed after the second
+   Complexity O(log(n)) amortized
+ */
+static inline STRUCT * FUNCTION(pop)(STRUCT ** head, int (*compare)(STRUCT *, STRUCT *))
+{
+    return (STRUCT *)ph_pop((PH_TYPE)head, OFFSET, CHILD, PARENT, (LL_COMPARE)compare);
+}
+
+/* meld heap "heap" into head
+   compare must return:
+     >= 0 if the first argument should be placed before the second
+     < 0 if the first argument should be placed after the second
+   Complexity O(1)
+ */
+static inline void FUNCTION(meld)(STRUCT ** head, STRUCT * heap, int (*compare)(STRUCT *, STRUCT *))
+{
+    ph_meld((PH_TYPE)head, OFFSET, CHILD, PARENT, heap, (LL_COMPARE)compare);
+}
+
+/* restore the heap after the key of item was changed so that it
+   is placed earlier than before
+   compare must return:
+     >= 0 if the first argument should be placed before the second
+     < 0 if the first argument should be placed after the second
+   Complexity O(1), the cost is paid by the next pop
+ */
+static inline void FUNCTION(decrease)(STRUCT ** head, STRUCT * item, int (*compare)(STRUCT *, STRUCT *))
+{
+    ph_decrease((PH_TYPE)head, OFFSET, CHILD, PARENT, item, (LL_COMPARE)compare);
+}
+
+/* remove item from the heap
+   returns the removed item
+   compare must return:
+     >= 0 if the first argument should be placed before the second
+     < 0 if the first argument should be placed after the second
+   Complexity O(log(n)) amortized
+ */
+static inline STRUCT * FUNCTION(remove)(STRUCT ** head, STRUCT * item, int (*compare)(STRUCT *, STRUCT *))
+{
+    return (STRUCT *)ph_remove((PH_TYPE)head, OFFSET, CHILD, PARENT, item, (LL_COMPARE)compare);
+}
+
+/* un-define all the template magic */
+#undef PREFIX
+#undef STRUCT
+#undef OFFSET
+#undef CHILD
+#undef PARENT
+
+#undef TEMPLATE_PREFIX
+#undef TEMPLATE_STRUCT
+
+#undef FUNCTION
+
+#endif // TEMPLATE
@@ -0,0 +1,281 @@
+#include <stdlib.h>
+#include "RcuList.h"
+
+/* assumes variable "o" is the offset where the void * NEXT element is located */
+#define NEXT(x) offsetin(x, o, void *)
+
+/* NEXT as read by a reader, pairs with the release store of a writer */
+#define NEXT_ACQUIRE(x) atomic_load_ptr(&NEXT(x))
+
+/* start with no readers and nothing retired
+   reclaim is called with each removed item and param once its grace period is over
+ */
+void rcu_init(RCU_DOMAIN * const domain, void (*reclaim)(void *, void *), void * const param)
+{
+    mutex_init(&domain->lock);
+    domain->epoch = 0;
+    domain->readers = NULL;
+    domain->limbo[0] = domain->limbo[1] = domain->limbo[2] = NULL;
+    domain->reclaim = reclaim;
+    domain->param = param;
+}
+
+/* reclaim every retired item in list */
+static void rcu_reclaim(RCU_DOMAIN * const domain, RCU_RETIRED * list)
+{
+    RCU_RETIRED * r;
+
+    while(list)
+    {
+        r = list;
+        list = r->next;
+        if(domain->reclaim) domain->reclaim(r->item, domain->param);
+        free(r);
+    }
+}
+
+/* reclaim everything still retired, no reader may be reading */
+void rcu_destroy(RCU_DOMAIN * const domain)
+{
+    int i;
+
+    for(i=0; i < 3; i++)
+    {
+        rcu_reclaim(domain, domain->limbo[i]);
+        domain->limbo[i] = NULL;
+    }
+    mutex_destroy(&domain->lock);
+}
+
+/* add reader to the domain, must be done before its first rcu_read_lock */
+void rcu_register(RCU_DOMAIN * const domain, RCU_READER * const reader)
+{
+    reader->state = 0;
+
+    mutex_lock(&domain->lock);
+    reader->next = domain->readers;
+    domain->readers = reader;
+    mutex_unlock(&domain->lock);
+}
+
+/* remove reader from the domain, it must not be reading */
+void rcu_unregister(RCU_DOMAIN * const domain, RCU_READER * const reader)
+{
+    RCU_READER ** r;
+
+    mutex_lock(&domain->lock);
+    for(r = &domain->readers; *r; r = &(*r)->next)
+    {
+        if(*r == reader)
+        {
+            *r = reader->next;
+            break;
+        }
+    }
+    mutex_unlock(&domain->lock);
+}
+
+/* start reading, items found until rcu_read_unlock will not be reclaimed
+   Complexity O(1), never blocks
+ */
+void rcu_read_lock(RCU_DOMAIN * const domain, RCU_READER * const reader)
+{
+    size_t epoch;
+
+    /* announce the epoch, then make sure it did not advance before the
+       announcement was visible, otherwise a writer may have missed it */
+    do
+    {
+        epoch = atomic_load_size(&domain->epoch);
+        atomic_store_size(&reader->state, (epoch << 1) | 1);
+        atomic_fence();
+    } while(atomic_load_size(&domain->epoch) != epoch);
+}
+
+/* stop reading, items found since rcu_read_lock must not be used anymore
+   Complexity O(1)
+ */
+void rcu_read_unlock(RCU_READER * const reader)
+{
+    atomic_store_size(&reader->state, 0);
+}
+
+/* advance the epoch if every active reader has announced the current one,
+   then reclaim the items retired two epochs ago
+   must be called with the lock held
+   returns 1 if the epoch advanced
+ */
+static int rcu_advance(RCU_DOMAIN * const domain)
+{
+    RCU_READER * r;
+    RCU_RETIRED * list;
+    size_t state, epoch = domain->epoch;
+
+    atomic_fence();
+    for(r = domain->readers; r; r = r->next)
+    {
+        state = atomic_load_size(&r->state);
+        if((state & 1) && (state >> 1) != epoch) return 0;
+    }
+
+    epoch++;
+    atomic_store_size(&domain->epoch, epoch);
+
+    /* the readers have all moved past the epoch before last */
+    list = domain->limbo[(epoch + 1) % 3];
+    domain->limbo[(epoch + 1) % 3] = NULL;
+    rcu_reclaim(domain, list);
+    return 1;
+}
+
+/* advance the epoch twice, waiting for readers as needed, which reclaims
+   every item retired before this call
+   must be called with the lock held, the lock is released while waiting
+ */
+static void rcu_grace_period(RCU_DOMAIN * const domain)
+{
+    const size_t target = domain->epoch + 2;
+
+    while(domain->epoch < target)
+    {
+        if(!rcu_advance(domain))
+        {
+            mutex_unlock(&domain->lock);
+            thread_yield();
+            mutex_lock(&domain->lock);
+        }
+    }
+}
+
+/* hand item to the domain to be reclaimed after the grace period
+   must be called with the lock held
+ */
+static void rcu_retire(RCU_DOMAIN * const domain, void * const item)
+{
+    RCU_RETIRED * r = malloc(sizeof(RCU_RETIRED));
+
+    if(r == NULL)
+    {
+        /* wait out the grace period here instead */
+        rcu_grace_period(domain);
+        if(domain->reclaim) domain->reclaim(item, domain->param);
+        return;
+    }
+
+    r->item = item;
+    r->next = domain->limbo[domain->epoch % 3];
+    domain->limbo[domain->epoch % 3] = r;
+
+    /* opportunistic, reclaims older items if no reader is in the way */
+    rcu_advance(domain);
+}
+
+/* wait until every item removed before this call has been reclaimed
+   must not be called while reading
+ */
+void rcu_synchronize(RCU_DOMAIN * const domain)
+{
+    mutex_lock(&domain->lock);
+    rcu_grace_period(domain);
+    mutex_unlock(&domain->lock);
+}
+
+/* searches for item in the linked list
+   returns the found item, or NULL if not found
+   Complexity O(n)
+ */
+void * rcu_ll_find(const LL_TYPE head, const size_t o, void * const item, int (*compare)(void *, void *))
+{
+    void * x;
+
+    /* iterate till item is found or end of list */
+    for(x=atomic_load_ptr(head); x; x = NEXT_ACQUIRE(x))
+    {
+        if(compare(x, item) == 0) return x;
+    }
+
+    /* item was not found */
+    return NULL;
+}
+
+/* executes function fn on each item in the linked list
+   Complexity O(n)
+ */
+void rcu_ll_each(const LL_TYPE head, const size_t o, void (*fn)(void *, void *), void * param)
+{
+    void * x;
+    for(x=atomic_load_ptr(head); x; x = NEXT_ACQUIRE(x)) fn(x, param);
+}
+
+/* returns an iterator for this linked list
+   Complexity O(1)
+ */
+LL_ITERATOR rcu_ll_iter(const LL_TYPE head)
+{
+    return (LL_ITERATOR){ atomic_load_ptr(head) };
+}
+
+/* advances the iterator, or sets it to NULL if this is the end of the list
+   Complexity O(1)
+ */
+void rcu_ll_iter_next(LL_ITERATOR * const it, const size_t o)
+{
+    it->n = NEXT_ACQUIRE(it->n);
+}
+
+/* push item to the beginning of the linked list
+   Complexity O(1)
+ */
+void rcu_ll_push(RCU_DOMAIN * const domain, LL_TYPE head, const size_t o, void * const item)
+{
+    mutex_lock(&domain->lock);
+    NEXT(item) = *head;
+    atomic_store_ptr(head, item); /* publish */
+    mutex_unlock(&domain->lock);
+}
+
+/* append item to the end of the linked list
+   Complexity O(n)
+ */
+void rcu_ll_append(RCU_DOMAIN * const domain, LL_TYPE head, const size_t o, void * const item)
+{
+    void ** x;
+
+    mutex_lock(&domain->lock);
+    /* iterate to the NULL pointer at the end of list */
+    for(x=head; *x; x = &NEXT(*x))
+        ;
+    NEXT(item) = NULL;
+    atomic_store_ptr(x, item); /* publish */
+    mutex_unlock(&domain->lock);
+}
+
+/* remove item from the linked list
+   NEXT of item is left alone since readers may still be following it,
+   item is reclaimed once no reader can reach it
+   returns the removed item, or NULL if it was not found
+   Complexity O(n)
+ */
+void * rcu_ll_remove(RCU_DOMAIN * const domain, LL_TYPE head, const size_t o, void * const item)
+{
+    void ** x;
+
+    if(item == NULL) return NULL;
+
+    mutex_lock(&domain->lock);
+    /* iterate till the pointer to item is found or end of list */
+    for(x=head; *x; x = &NEXT(*x))
+    {
+        if(*x == item)
+        {
+            atomic_store_ptr(x, NEXT(item)); /* unpublish */
+            rcu_retire(domain, item);
+            mutex_unlock(&domain->lock);
+            return item;
+        }
+    }
+    mutex_unlock(&domain->lock);
+
+    /* item was not found */
+    return NULL;
+}
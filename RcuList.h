@@ -0,0 +1,150 @@
+#ifndef __RCU_LIST_H__
+#define __RCU_LIST_H__
+
+#include <stddef.h>
+#include "Template.h"
+#include "LinkedListTypes.h"
+#include "Thread.h"
+
+/* A linked list for many readers and rare writers, in the style of RCU
+   (read-copy-update). Readers never block, they follow NEXT with acquire
+   loads. Writers take the lock of the domain and publish every change to a
+   link with a release store, so a reader sees either the old or the new list.
+
+   A removed item may still be in use by a reader, so it is only reclaimed
+   after a grace period. Every reader announces the global epoch when it starts
+   reading. The epoch only advances when every active reader has announced the
+   current epoch, so once it has advanced twice since an item was removed no
+   reader can still hold that item.
+ */
+
+/* one for each thread that reads, registered with the domain */
+typedef struct RCU_READER {
+    struct RCU_READER * next;
+    volatile size_t state; /* (epoch << 1) | 1 while reading, 0 otherwise */
+} RCU_READER;
+
+/* a removed item waiting for its grace period */
+typedef struct RCU_RETIRED {
+    struct RCU_RETIRED * next;
+    void * item;
+} RCU_RETIRED;
+
+typedef struct {
+    mutex_t lock;            /* taken by writers */
+    volatile size_t epoch;
+    RCU_READER * readers;
+    RCU_RETIRED * limbo[3];  /* items removed in each of the last three epochs */
+    void (*reclaim)(void * item, void * param);
+    void * param;
+} RCU_DOMAIN;
+
+void rcu_init(RCU_DOMAIN * domain, void (*reclaim)(void *, void *), void * param);
+void rcu_destroy(RCU_DOMAIN * domain);
+void rcu_register(RCU_DOMAIN * domain, RCU_READER * reader);
+void rcu_unregister(RCU_DOMAIN * domain, RCU_READER * reader);
+void rcu_read_lock(RCU_DOMAIN * domain, RCU_READER * reader);
+void rcu_read_unlock(RCU_READER * reader);
+void rcu_synchronize(RCU_DOMAIN * domain);
+
+void * rcu_ll_find(const LL_TYPE head, size_t o, void * item, LL_COMPARE);
+void rcu_ll_each(const LL_TYPE head, size_t o, void (*fn)(void *, void *), void * param);
+LL_ITERATOR rcu_ll_iter(const LL_TYPE head);
+void rcu_ll_iter_next(LL_ITERATOR * it, size_t o);
+
+void rcu_ll_push(RCU_DOMAIN * domain, LL_TYPE head, size_t o, void * item);
+void rcu_ll_append(RCU_DOMAIN * domain, LL_TYPE head, size_t o, void * item);
+void * rcu_ll_remove(RCU_DOMAIN * domain, LL_TYPE head, size_t o, void * item);
+
+#endif // !__RCU_LIST_H__
+
+#if defined(TEMPLATE_PREFIX) && defined(TEMPLATE_STRUCT)
+
+/*shorter versions of the template definitions*/
+#define PREFIX PPCAT(TEMPLATE_PREFIX, _)
+#define STRUCT TEMPLATE_STRUCT
+#define OFFSET offsetof(STRUCT, next)
+
+#define FUNCTION(name) PPCAT(PREFIX, name)
+
+/* find a match to item in the linked list
+   must be called between rcu_read_lock and rcu_read_unlock
+   compare must return:
+     == 0 if this is the desired item in the list
+   item will be passed to compare as the second argument
+   Complexity O(n)
+ */
+static inline STRUCT * FUNCTION(find)(STRUCT ** head, void * item, int (*compare)(STRUCT *, void *))
+{
+    return (STRUCT *)rcu_ll_find((LL_TYPE)head, OFFSET, item, (LL_COMPARE)compare);
+}
+
+/* executes function fn on each item in the linked list
+   must be called between rcu_read_lock and rcu_read_unlock
+   Complexity O(n)
+ */
+static inline void FUNCTION(each)(STRUCT ** head, void (*fn)(STRUCT *, void *), void * param)
+{
+    rcu_ll_each((LL_TYPE)head, OFFSET, (void (*)(void *, void *))fn, param);
+}
+
+static inline LL_ITERATOR FUNCTION(iter)(STRUCT ** head)
+{
+    return rcu_ll_iter((LL_TYPE)head);
+}
+
+static inline STRUCT * FUNCTION(iter_val)(LL_ITERATOR * it)
+{
+    return it->n;
+}
+
+static inline void FUNCTION(iter_next)(LL_ITERATOR * it)
+{
+    rcu_ll_iter_next(it, OFFSET);
+}
+
+/* push item to the beginning of the linked list
+   Complexity O(1)
+ */
+static inline void FUNCTION(push)(RCU_DOMAIN * domain, STRUCT ** head, STRUCT * item)
+{
+    rcu_ll_push(domain, (LL_TYPE)head, OFFSET, item);
+}
+
+/* append item to the end of the linked list
+   Complexity O(n)
+ */
+static inline void FUNCTION(append)(RCU_DOMAIN * domain, STRUCT ** head, STRUCT * item)
+{
+    rcu_ll_append(domain, (LL_TYPE)head, OFFSET, item);
+}
+
+/* remove item from the linked list, it is reclaimed after the grace period
+   returns the removed item, or NULL if it was not found
+   Complexity O(n)
+ */
+static inline STRUCT * FUNCTION(remove)(RCU_DOMAIN * domain, STRUCT ** head, STRUCT * item)
+{
+    return (STRUCT *)rcu_ll_remove(domain, (LL_TYPE)head, OFFSET, item);
+}
+
+#ifndef for_each
+/* Shorthand for:
+ * for (i = PREFIX_iter(ll); v = PREFIX_iter_val(&i); PREFIX_iter_next(&i)) */
+#define for_each(pre, ll, v, i) for \
+    (i = PPCAT(PPCAT(pre, _), iter)(ll);\
+    v = PPCAT(PPCAT(pre, _), iter_val)(&i);\
+    PPCAT(PPCAT(pre, _), iter_next)(&i))
+#endif // !for_each
+
+/* un-define all the template magic */
+#undef PREFIX
+#undef STRUCT
+#undef OFFSET
+
+#undef TEMPLATE_PREFIX
+#undef TEMPLATE_STRUCT
+
+#undef FUNCTION
+
+#endif // TEMPLATE
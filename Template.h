@@ -0,0 +1,17 @@
+#ifndef __TEMPLATE_H__
+#define __TEMPLATE_H__
+
+/* Concatenate preprocessor tokens A and B without expanding macro definitions
+   (however, if invoked from a macro, macro arguments are expanded).
+ */
+#define PPCAT_NX(A, B) A ## B
+
+/* Concatenate preprocessor tokens A and B after macro-expanding them.
+ */
+#define PPCAT(A, B) PPCAT_NX(A, B)
+
+/* Extract an element of type (member_type) at offset (offset) in the structure pointed to by (ptr)
+ */
+#define offsetin(ptr, offset, member_type) *((member_type*)((char*)ptr + offset))
+
+#endif // !__TEMPLATE_H__
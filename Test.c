@@ -1,5 +1,10 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LruCache.h"
+#include "TimingWheel.h"
 
 //#define FROM_NEXT_TO_TEST_T(n) (test_t*)((char *)n - OFFSETOF(test_t, next))
 
@@ -83,7 +88,7 @@ void list_test(void)
     int i, j, tmp, cnt;
     (void)r2;
 
-    printf("length when empty: %d\r\n", test1_length(&head1));
+    printf("length when empty: %d\r\n", (int)test1_length(&head1));
 
     for(i=0; i < 26; i++)
     {
@@ -94,7 +99,7 @@ void list_test(void)
         test2_push(&head2, &buf2[i]);
     }
 
-    printf("length when full: %d\r\n", test1_length(&head1));
+    printf("length when full: %d\r\n", (int)test1_length(&head1));
 
     test1_each(&head1, test1_print, NULL);
     test2_each(&head2, test2_print, NULL);
@@ -208,4 +213,1029 @@ void list_test(void)
     test1_each(&head1, test1_print, NULL);
 
     //received_message(0, 100, (uint8_t*)"The quick Brown Fox Jumped over the Lazy Dog");
-}
\ No newline at end of file
+}
+typedef struct test3_struct
+{
+    struct test3_struct * next;
+    struct test3_struct * child;
+    struct test3_struct * prev;
+    char data;
+} test3_t;
+
+#define TEMPLATE_PREFIX test3
+#define TEMPLATE_STRUCT test3_t
+#include "PairingHeap.h"
+
+int test3_compare(test3_t * x, test3_t * y)
+{
+    return y->data - x->data;
+}
+
+void test3_drain(test3_t ** heap)
+{
+    test3_t * t3;
+    while((t3 = test3_pop(heap, test3_compare)))
+        printf("%c%s", t3->data, *heap ? "->" : "");
+    printf("\r\n");
+}
+
+void heap_test(void)
+{
+    test3_t buf3[26];
+    test3_t * heap3 = NULL, * other3 = NULL;
+    int i;
+
+    printf("testing pairing heap\r\n");
+
+    /* push in a scrambled order, 7 is co-prime with 26 */
+    for(i=0; i < 26; i++)
+    {
+        buf3[i].data = 'A' + (i * 7) % 26;
+        test3_push(&heap3, &buf3[i], test3_compare);
+    }
+    printf("first: %c\r\n", test3_peek(&heap3)->data);
+    test3_drain(&heap3);
+
+    /* split across two heaps then meld */
+    for(i=0; i < 26; i++)
+        test3_push(i & 1 ? &heap3 : &other3, &buf3[i], test3_compare);
+    test3_meld(&heap3, other3, test3_compare);
+    test3_drain(&heap3);
+
+    /* decrease-key, the digits should come out first */
+    for(i=0; i < 26; i++)
+        test3_push(&heap3, &buf3[i], test3_compare);
+    test3_pop(&heap3, test3_compare); /* pop once so the heap is not flat */
+    for(i=0; i < 26; i += 5)
+    {
+        if(buf3[i].data == 'A') continue; /* already popped */
+        buf3[i].data = '0' + i / 5;
+        test3_decrease(&heap3, &buf3[i], test3_compare);
+    }
+    test3_drain(&heap3);
+
+    /* remove every other item */
+    for(i=0; i < 26; i++)
+    {
+        buf3[i].data = 'A' + i;
+        test3_push(&heap3, &buf3[i], test3_compare);
+    }
+    test3_pop(&heap3, test3_compare);
+    for(i=1; i < 26; i += 2)
+        test3_remove(&heap3, &buf3[i], test3_compare);
+    test3_drain(&heap3);
+}
+
+typedef struct test4_struct
+{
+    LL_REL next;
+    char data;
+} test4_t;
+
+#define TEMPLATE_PREFIX test4
+#define TEMPLATE_STRUCT test4_t
+#define TEMPLATE_RELATIVE
+#include "LinkedList.h"
+
+/* a self-relative list and all of its nodes in one block of memory */
+typedef struct
+{
+    LL_REL head;
+    test4_t nodes[26];
+} test4_block_t;
+
+void test4_print(test4_t * t, void * param)
+{
+    printf("%c%s", t->data, t->next ? "->" : "\r\n");
+}
+
+int test4_compare(test4_t * x, test4_t * y)
+{
+    return y->data - x->data;
+}
+
+int test4_match(test4_t * x, void * data)
+{
+    return x->data - *(char *)data;
+}
+
+void relative_test(void)
+{
+    static test4_block_t block, copy;
+    test4_block_t * mapped;
+    test4_t * t4;
+    LL_ITERATOR it;
+    LL_MAP map;
+    int i;
+
+    printf("testing self-relative links\r\n");
+
+    block.head = 0;
+    for(i=0; i < 26; i++)
+    {
+        block.nodes[i].data = 'A' + (i * 7) % 26;
+        test4_push(&block.head, &block.nodes[i]);
+    }
+    test4_each(&block.head, test4_print, NULL);
+    test4_sort(&block.head, test4_compare);
+    test4_each(&block.head, test4_print, NULL);
+    test4_append(&block.head, test4_pop(&block.head));
+    test4_sort2(&block.head, test4_compare);
+    printf("length: %d\r\n", (int)test4_length(&block.head));
+
+    /* the links stay valid when the block is moved */
+    copy = block;
+    memset(&block, 0, sizeof(block));
+    for_each(test4, &copy.head, t4, it)
+        printf("%c%s", t4->data, t4->next ? "->" : "\r\n");
+
+    /* and when it is written to disk and mapped back */
+    if(ll_rel_save("relative_test.bin", &copy, sizeof(copy)) != 0)
+    {
+        printf("save failed\r\n");
+        return;
+    }
+    mapped = ll_rel_load("relative_test.bin", &map);
+    if(mapped == NULL)
+    {
+        printf("load failed\r\n");
+        return;
+    }
+    test4_remove(&mapped->head, test4_find(&mapped->head, "A", test4_match));
+    test4_each(&mapped->head, test4_print, NULL);
+    ll_rel_unload(&map);
+    remove("relative_test.bin");
+}
+
+typedef struct test5_struct
+{
+    LL_IDX next;
+    char data;
+} test5_t;
+
+static test5_t buf5[26];
+static LL_POOL test5_pool = LL_POOL_INIT(buf5, test5_t);
+
+#define TEMPLATE_PREFIX test5
+#define TEMPLATE_STRUCT test5_t
+#define TEMPLATE_POOL (&test5_pool)
+#include "LinkedList.h"
+
+void test5_print(test5_t * t, void * param)
+{
+    printf("%c%s", t->data, t->next != LL_IDX_NULL ? "->" : "\r\n");
+}
+
+int test5_compare(test5_t * x, test5_t * y)
+{
+    return y->data - x->data;
+}
+
+int test5_compare_reversed(test5_t * x, test5_t * y)
+{
+    return x->data - y->data;
+}
+
+void index_test(void)
+{
+    LL_IDX head5 = LL_IDX_NULL, t5 = LL_IDX_NULL;
+    test5_t * x5;
+    LL_ITERATOR it;
+    int i;
+
+    printf("testing index links\r\n");
+    printf("node size: %d\r\n", (int)sizeof(test5_t));
+
+    for(i=0; i < 26; i++)
+    {
+        buf5[i].data = 'A' + (i * 7) % 26;
+        test5_push(&head5, &buf5[i]);
+    }
+    test5_each(&head5, test5_print, NULL);
+
+    test5_sort(&head5, test5_compare);
+    test5_each(&head5, test5_print, NULL);
+
+    test5_sort2(&head5, test5_compare_reversed);
+    test5_each(&head5, test5_print, NULL);
+
+    test5_append(&head5, test5_pop(&head5));
+    test5_push(&head5, test5_deduct(&head5));
+    for(i=0; i < 26; i += 3)
+        test5_append(&t5, test5_remove(&head5, &buf5[i]));
+    printf("length: %d, removed: %d\r\n", (int)test5_length(&head5), (int)test5_length(&t5));
+
+    test5_sort(&head5, test5_compare);
+    test5_sort(&t5, test5_compare);
+    test5_merge(&head5, test5_pop(&t5), test5_compare);
+    test5_merge2(&head5, ll_idx_get(&test5_pool, &t5), test5_compare, 26);
+
+    for_each(test5, &head5, x5, it)
+        printf("%c%s", x5->data, x5->next != LL_IDX_NULL ? "->" : "\r\n");
+}
+
+/* build a sorted list from the letters in s */
+test1_t * test1_build(test1_t * buf, const char * s)
+{
+    test1_t * head = NULL;
+    int i;
+    for(i=0; s[i]; i++)
+    {
+        buf[i].data = s[i];
+        buf[i].next = NULL;
+        test1_append(&head, &buf[i]);
+    }
+    return head;
+}
+
+void set_test(void)
+{
+    test1_t bufa[26], bufb[26];
+    test1_t * a, * b, * dropped;
+
+    printf("testing set operations\r\n");
+
+    a = test1_build(bufa, "AABCCCDEFFG");
+    dropped = test1_unique(&a, test1_compare);
+    printf("unique: "); test1_each(&a, test1_print, NULL);
+    printf("dropped: "); test1_each(&dropped, test1_print, NULL);
+
+    a = test1_build(bufa, "ACEGIK");
+    b = test1_build(bufb, "ABCDLM");
+    dropped = test1_union(&a, b, test1_compare);
+    printf("union: "); test1_each(&a, test1_print, NULL);
+    printf("dropped: "); test1_each(&dropped, test1_print, NULL);
+
+    a = test1_build(bufa, "ACEGIK");
+    b = test1_build(bufb, "ABCDKM");
+    dropped = test1_intersect(&a, b, test1_compare);
+    printf("intersect: "); test1_each(&a, test1_print, NULL);
+    printf("dropped: "); test1_each(&dropped, test1_print, NULL);
+
+    a = test1_build(bufa, "ACEGIK");
+    b = test1_build(bufb, "ABCDKM");
+    dropped = test1_difference(&a, b, test1_compare);
+    printf("difference: "); test1_each(&a, test1_print, NULL);
+    printf("dropped: "); test1_each(&dropped, test1_print, NULL);
+
+    a = test1_build(bufa, "ACE");
+    dropped = test1_difference(&a, NULL, test1_compare);
+    printf("difference with empty: "); test1_each(&a, test1_print, NULL);
+    dropped = test1_intersect(&a, NULL, test1_compare);
+    printf("intersect with empty: "); test1_each(&a, test1_print, NULL);
+    printf("dropped: "); test1_each(&dropped, test1_print, NULL);
+}
+
+/* a set operation, its inputs and the sequences it should leave */
+typedef struct
+{
+    char op; /* 'u'nique, '+' union, '&' intersect, '-' difference */
+    const char * a, * b, * result, * dropped;
+} set_case_t;
+
+static const set_case_t set_cases[] =
+{
+    { 'u', "AABCCCDEFFG", "", "ABCDEFG", "ACCF" },
+    { 'u', "AAAA", "", "A", "AAA" },
+    { 'u', "", "", "", "" },
+    { '+', "ACEGIK", "ABCDLM", "ABCDEGIKLM", "AC" },
+    { '+', "ACE", "BDF", "ABCDEF", "" },
+    { '+', "ABC", "ABC", "ABC", "ABC" },
+    { '+', "", "ABC", "ABC", "" },
+    { '&', "ACEGIK", "ABCDKM", "ACK", "ABCDEGIKM" },
+    { '&', "ACE", "BDF", "", "ABCDEF" },
+    { '&', "ABC", "ABC", "ABC", "ABC" },
+    { '&', "ABC", "", "", "ABC" },
+    { '-', "ACEGIK", "ABCDKM", "EGI", "AABCCDKKM" },
+    { '-', "ACE", "BDF", "ACE", "BDF" },
+    { '-', "ABC", "ABC", "", "AABBCC" },
+    { '-', "", "ABC", "", "ABC" },
+    { '+', "B", "ABBC", "ABC", "BB" },
+    { '+', "ABBC", "BB", "ABBC", "BB" },
+    { '&', "ABBC", "B", "BB", "ABC" },
+    { '&', "ABBC", "BBB", "BB", "ABBBC" },
+    { '&', "BB", "ABBB", "BB", "ABBB" },
+    { '-', "ABBC", "B", "AC", "BBB" },
+    { '-', "ABBC", "BBB", "AC", "BBBBB" },
+    { '-', "BB", "ABB", "", "ABBBB" },
+};
+
+/* both lists of a set operation and their nodes in one block of memory */
+typedef struct
+{
+    LL_REL a, b;
+    test4_t nodes[26];
+} test4_sets_t;
+
+/* build a self-relative list of the chars in s from nodes */
+static void test4_build(LL_REL * head, test4_t * nodes, const char * s)
+{
+    size_t i;
+
+    *head = 0;
+    for(i=0; s[i]; i++)
+    {
+        nodes[i].data = s[i];
+        nodes[i].next = 0;
+        test4_append(head, &nodes[i]);
+    }
+}
+
+/* copy the data of the self-relative nodes from t on into s */
+static void test4_string(test4_t * t, char * s)
+{
+    for(; t; t = ll_rel_get(&t->next)) *s++ = t->data;
+    *s = 0;
+}
+
+static int test4_set_case(const set_case_t * c, char * result, char * dropped)
+{
+    static test4_sets_t sets;
+    test4_t * d = NULL;
+
+    test4_build(&sets.a, sets.nodes, c->a);
+    test4_build(&sets.b, sets.nodes + 13, c->b);
+    switch(c->op)
+    {
+    case 'u': d = test4_unique(&sets.a, test4_compare); break;
+    case '+': d = test4_union(&sets.a, ll_rel_get(&sets.b), test4_compare); break;
+    case '&': d = test4_intersect(&sets.a, ll_rel_get(&sets.b), test4_compare); break;
+    case '-': d = test4_difference(&sets.a, ll_rel_get(&sets.b), test4_compare); break;
+    }
+    test4_string(ll_rel_get(&sets.a), result);
+    test4_string(d, dropped);
+    return strcmp(result, c->result) == 0 && strcmp(dropped, c->dropped) == 0;
+}
+
+/* build an index list of the chars in s from nodes in test5_pool */
+static void test5_build(LL_IDX * head, test5_t * nodes, const char * s)
+{
+    size_t i;
+
+    *head = LL_IDX_NULL;
+    for(i=0; s[i]; i++)
+    {
+        nodes[i].data = s[i];
+        nodes[i].next = LL_IDX_NULL;
+        test5_append(head, &nodes[i]);
+    }
+}
+
+/* copy the data of the index nodes from t on into s */
+static void test5_string(test5_t * t, char * s)
+{
+    for(; t; t = ll_idx_get(&test5_pool, &t->next)) *s++ = t->data;
+    *s = 0;
+}
+
+static int test5_set_case(const set_case_t * c, char * result, char * dropped)
+{
+    LL_IDX a, b;
+    test5_t * d = NULL;
+
+    test5_build(&a, buf5, c->a);
+    test5_build(&b, buf5 + 13, c->b);
+    switch(c->op)
+    {
+    case 'u': d = test5_unique(&a, test5_compare); break;
+    case '+': d = test5_union(&a, ll_idx_get(&test5_pool, &b), test5_compare); break;
+    case '&': d = test5_intersect(&a, ll_idx_get(&test5_pool, &b), test5_compare); break;
+    case '-': d = test5_difference(&a, ll_idx_get(&test5_pool, &b), test5_compare); break;
+    }
+    test5_string(ll_idx_get(&test5_pool, &a), result);
+    test5_string(d, dropped);
+    return strcmp(result, c->result) == 0 && strcmp(dropped, c->dropped) == 0;
+}
+
+/* run every set case on self-relative and index lists */
+void set_modes_test(void)
+{
+    char result[27], dropped[27];
+    const set_case_t * c;
+    size_t i;
+    int ok;
+
+    printf("testing set operations on relative and index links\r\n");
+
+    for(i=0; i < sizeof(set_cases) / sizeof(set_cases[0]); i++)
+    {
+        c = &set_cases[i];
+        ok = test4_set_case(c, result, dropped);
+        printf("relative %s %c %s: %s, dropped: %s%s\r\n", c->a, c->op, c->b, result, dropped, ok ? "" : " WRONG");
+        ok = test5_set_case(c, result, dropped);
+        printf("index    %s %c %s: %s, dropped: %s%s\r\n", c->a, c->op, c->b, result, dropped, ok ? "" : " WRONG");
+    }
+}
+
+typedef struct test6_struct
+{
+    struct test6_struct * next;
+    int value;
+} test6_t;
+
+#define TEMPLATE_PREFIX test6
+#define TEMPLATE_STRUCT test6_t
+#include "LinkedList.h"
+
+#define TEMPLATE_PREFIX test6
+#define TEMPLATE_STRUCT test6_t
+#include "LinkedListParallel.h"
+
+void test6_double(test6_t * t, void * param)
+{
+    t->value *= 2;
+}
+
+void test6_sum(test6_t * t, void * acc, void * param)
+{
+    *(long long *)acc += t->value;
+}
+
+void test6_combine(void * result, void * acc, void * param)
+{
+    *(long long *)result += *(long long *)acc;
+}
+
+void parallel_test(void)
+{
+    static test6_t buf6[100000];
+    test6_t * head6 = NULL;
+    THREAD_POOL * pool;
+    long long sum = 0;
+    int i;
+
+    printf("testing parallel each\r\n");
+
+    for(i=0; i < 100000; i++)
+    {
+        buf6[i].value = i;
+        test6_push(&head6, &buf6[i]);
+    }
+
+    pool = tp_create(4);
+    if(pool == NULL)
+    {
+        printf("failed to create pool\r\n");
+        return;
+    }
+
+    test6_each_parallel(&head6, test6_double, NULL, pool);
+    test6_reduce_parallel(&head6, test6_sum, NULL, test6_combine, &sum, sizeof(sum), pool);
+    printf("sum: %lld, expected: %lld\r\n", sum, 99999LL * 100000LL);
+
+    /* without a pool it runs on the calling thread */
+    sum = 0;
+    test6_reduce_parallel(&head6, test6_sum, NULL, test6_combine, &sum, sizeof(sum), NULL);
+    printf("serial sum: %lld\r\n", sum);
+
+    tp_destroy(pool);
+}
+
+#define TEST7_ALIVE 0x600D
+#define TEST7_DEAD 0xDEAD
+
+typedef struct test7_struct
+{
+    struct test7_struct * next;
+    int key;
+    volatile int magic;
+} test7_t;
+
+#define TEMPLATE_PREFIX test7
+#define TEMPLATE_STRUCT test7_t
+#include "RcuList.h"
+
+typedef struct
+{
+    RCU_DOMAIN domain;
+    test7_t * head;
+    volatile size_t done;
+    size_t errors[4];
+    size_t reads[4];
+} test7_shared_t;
+
+static test7_shared_t test7_shared;
+
+void test7_reclaim(void * item, void * param)
+{
+    ((test7_t *)item)->magic = TEST7_DEAD;
+    free(item);
+}
+
+int test7_match(test7_t * x, void * key)
+{
+    return x->key - *(int *)key;
+}
+
+static THREAD_FUNCTION(test7_reader, arg)
+{
+    size_t id = (size_t)arg;
+    RCU_READER reader;
+    LL_ITERATOR it;
+    test7_t * t7;
+
+    rcu_register(&test7_shared.domain, &reader);
+    while(!atomic_load_size(&test7_shared.done))
+    {
+        rcu_read_lock(&test7_shared.domain, &reader);
+        for_each(test7, &test7_shared.head, t7, it)
+        {
+            if(t7->magic != TEST7_ALIVE) test7_shared.errors[id]++;
+        }
+        rcu_read_unlock(&reader);
+        test7_shared.reads[id]++;
+    }
+    rcu_unregister(&test7_shared.domain, &reader);
+    THREAD_RETURN;
+}
+
+static test7_t * test7_new(int key)
+{
+    test7_t * t = malloc(sizeof(test7_t));
+    if(t)
+    {
+        t->key = key;
+        t->magic = TEST7_ALIVE;
+    }
+    return t;
+}
+
+void rcu_test(void)
+{
+    thread_t readers[4];
+    test7_t * t7;
+    unsigned int seed = 1;
+    size_t i, errors = 0, reads = 0;
+    int key, next_key = 0;
+
+    printf("testing rcu list\r\n");
+
+    rcu_init(&test7_shared.domain, test7_reclaim, NULL);
+    for(next_key=0; next_key < 64; next_key++)
+        if((t7 = test7_new(next_key))) test7_push(&test7_shared.domain, &test7_shared.head, t7);
+
+    for(i=0; i < 4; i++)
+        thread_start(&readers[i], test7_reader, (void *)i);
+
+    /* replace the oldest item many times while the readers traverse,
+       new items go to a random end of the list */
+    for(i=0; i < 100000; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        key = next_key - 64;
+        test7_remove(&test7_shared.domain, &test7_shared.head, test7_find(&test7_shared.head, &key, test7_match));
+        if((t7 = test7_new(next_key++)))
+        {
+            if(seed & 0x10000) test7_push(&test7_shared.domain, &test7_shared.head, t7);
+            else test7_append(&test7_shared.domain, &test7_shared.head, t7);
+        }
+        if(i % 1000 == 0) thread_yield();
+    }
+
+    atomic_store_size(&test7_shared.done, 1);
+    for(i=0; i < 4; i++)
+    {
+        thread_join(readers[i]);
+        errors += test7_shared.errors[i];
+        reads += test7_shared.reads[i];
+    }
+
+    rcu_synchronize(&test7_shared.domain);
+    printf("traversals: %s, reclaimed items seen: %d\r\n", reads ? "yes" : "no", (int)errors);
+
+    while((t7 = test7_shared.head))
+        test7_remove(&test7_shared.domain, &test7_shared.head, t7);
+    rcu_destroy(&test7_shared.domain);
+}
+
+/* nodes sorted by big_sort_test, large lists need 16 bytes per node
+   e.g. -DLL_BIG_TEST_NODES=3000000000 to go past 2^31 on a 64 GB machine */
+#ifndef LL_BIG_TEST_NODES
+#define LL_BIG_TEST_NODES ((size_t)1 << 20)
+#endif
+
+typedef struct test8_struct
+{
+    struct test8_struct * next;
+    uint32_t key;
+} test8_t;
+
+#define TEMPLATE_PREFIX test8
+#define TEMPLATE_STRUCT test8_t
+#include "LinkedList.h"
+
+static size_t test8_compares;
+
+int test8_compare(test8_t * x, test8_t * y)
+{
+    test8_compares++;
+    return (x->key <= y->key) - (x->key > y->key);
+}
+
+/* fill buf with n nodes of pseudo random keys and link them */
+static test8_t * test8_build(test8_t * buf, size_t n)
+{
+    test8_t * head = NULL;
+    uint32_t seed = 1;
+    size_t i;
+
+    for(i = n; i-- > 0;)
+    {
+        seed = seed * 1664525 + 1013904223;
+        buf[i].key = seed >> 8;
+        test8_push(&head, &buf[i]);
+    }
+    return head;
+}
+
+/* returns 1 if head holds n nodes in ascending order */
+static int test8_check(test8_t ** head, size_t n)
+{
+    test8_t * t;
+    size_t count = 0;
+
+    for(t = *head; t; t = t->next, count++)
+    {
+        if(t->next && t->next->key < t->key) return 0;
+    }
+    return count == n && test8_length(head) == n;
+}
+
+/* sort lists of n nodes with both engines, checking the order and that
+   the number of comparisons stays within n * ceil(log2(n)) */
+static void test8_sort_both(test8_t * buf, size_t n)
+{
+    test8_t * head;
+    size_t bound = 0, passes;
+    int ok1, ok2;
+
+    for(passes = 1; ((size_t)1 << passes) < n; passes++)
+        ;
+    bound = n * passes;
+
+    head = test8_build(buf, n);
+    test8_compares = 0;
+    test8_sort(&head, test8_compare);
+    ok1 = test8_check(&head, n) && test8_compares <= bound;
+
+    head = test8_build(buf, n);
+    test8_compares = 0;
+    test8_sort2(&head, test8_compare);
+    ok2 = test8_check(&head, n) && test8_compares <= bound;
+
+    printf("n: %.0f, sort: %s, sort2: %s\r\n", (double)n, ok1 ? "ok" : "WRONG", ok2 ? "ok" : "WRONG");
+}
+
+/* merge two sorted lists of 8 nodes with a limit n, the same size_t the sort
+   engines pass to merge2 for each pass, returns 1 if all 16 nodes came out in order
+   a limit truncated to int or to 32 bits would be negative or 0 and leave
+   the second list in front, unmerged */
+static int test8_merge_limit(size_t n)
+{
+    test8_t buf[16];
+    test8_t * a = NULL, * b = NULL;
+    int i;
+
+    for(i = 7; i >= 0; i--)
+    {
+        buf[2 * i].key = 2 * i;
+        test8_push(&a, &buf[2 * i]);
+        buf[2 * i + 1].key = 2 * i + 1;
+        test8_push(&b, &buf[2 * i + 1]);
+    }
+    test8_merge2(&a, b, test8_compare, n);
+    return test8_check(&a, 16) && a->key == 0;
+}
+
+/* sorting past 2^31 nodes needs LL_BIG_TEST_NODES raised and the memory
+   for it, only the merge limits above INT_MAX are checked by default */
+void big_sort_test(void)
+{
+    static const size_t sizes[] = { 0, 1, 2, 3, 1023, 1024, 1025, 65535, 65537 };
+    test8_t * buf = malloc(LL_BIG_TEST_NODES * sizeof(test8_t));
+    size_t i;
+
+    printf("testing sort with size_t counts\r\n");
+    if(buf == NULL)
+    {
+        printf("not enough memory for %.0f nodes\r\n", (double)LL_BIG_TEST_NODES);
+        return;
+    }
+
+    /* merge limits of the passes past 2^31 and 2^32 nodes, without the nodes */
+    printf("merge limit 2^31: %s\r\n", test8_merge_limit((size_t)INT_MAX + 1) ? "ok" : "WRONG");
+    if(SIZE_MAX > UINT32_MAX)
+        printf("merge limit 2^32 + 1: %s\r\n", test8_merge_limit((size_t)UINT32_MAX + 2) ? "ok" : "WRONG");
+
+    /* both sides of power of two boundaries, where the pass logic changes */
+    for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        if(sizes[i] <= LL_BIG_TEST_NODES) test8_sort_both(buf, sizes[i]);
+    }
+    test8_sort_both(buf, LL_BIG_TEST_NODES);
+
+    free(buf);
+}
+
+typedef struct test9_struct
+{
+    int key;
+    char data;
+    LRU_LINK lru;
+} test9_t;
+
+#define TEMPLATE_PREFIX test9
+#define TEMPLATE_STRUCT test9_t
+#include "LruCache.h"
+
+size_t test9_hash(void * key)
+{
+    return (size_t)*(int *)key * 2654435761u;
+}
+
+int test9_compare(test9_t * t, void * key)
+{
+    return t->key != *(int *)key;
+}
+
+void test9_evicted(test9_t * t, void * param)
+{
+    printf("evicted %c\r\n", t->data);
+}
+
+/* frees the item, for the caches that own their items */
+void test9_evicted_free(test9_t * t, void * param)
+{
+    printf("freed %c\r\n", t->data);
+    free(t);
+}
+
+/* print the cache oldest to newest */
+void test9_print(LRU_CACHE * cache)
+{
+    test9_t * t;
+
+    for(t = test9_oldest(cache); t; t = t->lru.newer)
+        printf("%c%s", t->data, t->lru.newer ? "<-" : "\r\n");
+}
+
+void lru_test(void)
+{
+    test9_t buf9[26];
+    LRU_CACHE * cache;
+    test9_t * t9;
+    int i, key;
+
+    printf("testing lru cache\r\n");
+
+    cache = test9_create(4, test9_hash, test9_compare, test9_evicted, NULL);
+    if(cache == NULL) return;
+
+    for(i=0; i < 26; i++)
+    {
+        buf9[i].key = i;
+        buf9[i].data = 'A' + i;
+    }
+
+    /* E evicts A */
+    for(i=0; i < 5; i++) test9_put(cache, &buf9[i], &buf9[i].key);
+    printf("oldest to newest: "); test9_print(cache);
+
+    /* getting B makes it the newest, so F evicts C */
+    key = 1;
+    t9 = test9_get(cache, &key);
+    printf("get 1: %c\r\n", t9 ? t9->data : '-');
+    key = 0;
+    t9 = test9_get(cache, &key);
+    printf("get 0: %c\r\n", t9 ? t9->data : '-');
+    test9_put(cache, &buf9[5], &buf9[5].key);
+    printf("oldest to newest: "); test9_print(cache);
+
+    /* peek leaves D the oldest, touch does not */
+    key = 3;
+    test9_peek(cache, &key);
+    printf("after peek: "); test9_print(cache);
+    test9_touch(cache, &buf9[3]);
+    printf("after touch: "); test9_print(cache);
+
+    /* Z takes the key of E, which is evicted in its place */
+    buf9[25].key = 4;
+    test9_put(cache, &buf9[25], &buf9[25].key);
+    printf("after replace: "); test9_print(cache);
+
+    test9_remove(cache, &buf9[1]);
+    printf("after remove: "); test9_print(cache);
+    printf("count: %d\r\n", (int)test9_count(cache));
+
+    test9_evict(cache);
+    test9_destroy(cache);
+
+    /* putting an item that is already cached, under its key or another,
+       moves it to the key as the newest, it must not be evicted, which
+       here would free it, nor be linked in twice */
+    cache = test9_create(4, test9_hash, test9_compare, test9_evicted_free, NULL);
+    if(cache == NULL) return;
+
+    for(i=0; i < 2; i++)
+    {
+        t9 = malloc(sizeof(test9_t));
+        if(t9 == NULL) break;
+        t9->key = i;
+        t9->data = 'a' + i;
+        test9_put(cache, t9, &t9->key);
+    }
+    /* a becomes the newest, twice over */
+    t9 = test9_oldest(cache);
+    if(t9) test9_put(cache, t9, &t9->key);
+    if(t9) test9_put(cache, t9, &t9->key);
+    printf("after put again: "); test9_print(cache);
+    printf("count: %d\r\n", (int)test9_count(cache));
+
+    /* b moves from key 1 to key 7 */
+    t9 = test9_oldest(cache);
+    if(t9)
+    {
+        t9->key = 7;
+        test9_put(cache, t9, &t9->key);
+    }
+    printf("after new key: "); test9_print(cache);
+    key = 1;
+    t9 = test9_peek(cache, &key);
+    printf("peek 1: %c", t9 ? t9->data : '-');
+    key = 7;
+    t9 = test9_peek(cache, &key);
+    printf(", peek 7: %c, count: %d\r\n", t9 ? t9->data : '-', (int)test9_count(cache));
+
+    test9_destroy(cache);
+}
+
+typedef struct test10_struct
+{
+    char data;
+    TW_LINK tw;
+} test10_t;
+
+#define TEMPLATE_PREFIX test10
+#define TEMPLATE_STRUCT test10_t
+#include "TimingWheel.h"
+
+/* advance wheel to now, printing what expired
+   returns the number of items that expired early */
+static int test10_print_advance(TIMING_WHEEL * wheel, uint64_t now)
+{
+    test10_t * t;
+    int wrong = 0;
+
+    printf("advance to %.0f: ", (double)now);
+    for(t = test10_advance(wheel, now); t; t = t->tw.next)
+    {
+        printf("%c ", t->data);
+        if(t->tw.expires > now) wrong++;
+    }
+    printf("\r\n");
+    return wrong;
+}
+
+void timer_test(void)
+{
+    static const uint64_t expires[] = { 1, 63, 64, 65, 4095, 4097, 300000, 20000000, 50, 100, 0 };
+    static test10_t buf10[2000];
+    static TIMING_WHEEL wheel;
+    test10_t * t;
+    uint32_t seed = 1;
+    uint64_t now;
+    size_t i, count = 0;
+    int wrong = 0;
+
+    printf("testing timing wheel\r\n");
+
+    test10_init(&wheel, 0);
+    for(i=0; i < sizeof(expires) / sizeof(expires[0]); i++)
+    {
+        buf10[i] = (test10_t){ .data = 'A' + (char)i };
+        test10_schedule(&wheel, &buf10[i], expires[i]);
+    }
+
+    /* I is cancelled, J moves from 100 to 10, K is already due */
+    test10_cancel(&wheel, &buf10[8]);
+    test10_schedule(&wheel, &buf10[9], 10);
+    printf("pending: %d, I pending: %d\r\n", (int)wheel.count, test10_pending(&buf10[8]));
+
+    wrong += test10_print_advance(&wheel, 1);
+    wrong += test10_print_advance(&wheel, 63);
+    wrong += test10_print_advance(&wheel, 64);
+    wrong += test10_print_advance(&wheel, 4096);
+    wrong += test10_print_advance(&wheel, 4097);
+    wrong += test10_print_advance(&wheel, 299999);
+    wrong += test10_print_advance(&wheel, 300000);
+    wrong += test10_print_advance(&wheel, 20000000);
+    printf("pending: %d, expired early: %d\r\n", (int)wheel.count, wrong);
+
+    /* random expiries across every level, cancelling every third */
+    test10_init(&wheel, 0);
+    for(i=0; i < 2000; i++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        buf10[i] = (test10_t){ .data = 'x' };
+        test10_schedule(&wheel, &buf10[i], seed >> 7);
+    }
+    for(i=0; i < 2000; i += 3) test10_cancel(&wheel, &buf10[i]);
+
+    for(now = 0; wheel.count; )
+    {
+        seed = seed * 1664525 + 1013904223;
+        now += seed >> 12;
+        for(t = test10_advance(&wheel, now); t; t = t->tw.next)
+        {
+            if(t->tw.expires > now || t->tw.expires <= now - (seed >> 12)) wrong++;
+            count++;
+        }
+    }
+    printf("random: expired %d of %d, early or late: %d\r\n", (int)count, 2000 - 667, wrong);
+
+    /* rescheduling items while walking the expired chain, A and B are due at 10
+       and come back at 510 with C, reading tw.next first keeps C in its slot */
+    test10_init(&wheel, 0);
+    for(i=0; i < 3; i++)
+    {
+        buf10[i] = (test10_t){ .data = 'A' + (char)i };
+        test10_schedule(&wheel, &buf10[i], i < 2 ? 10 : 510);
+    }
+    for(now = 10; now <= 510; now += 500)
+    {
+        test10_t * next;
+
+        printf("%d:", (int)now);
+        for(t = test10_advance(&wheel, now); t; t = next)
+        {
+            next = t->tw.next;
+            printf(" %c", t->data);
+            if(t->tw.expires != now) wrong++;
+            if(now == 10) test10_schedule(&wheel, t, now + 500);
+        }
+        printf("\r\n");
+    }
+    printf("rescheduled: pending: %d, early or late: %d\r\n", (int)wheel.count, wrong);
+}
+
+/* key is a char, returns > 0 while t is before the key in a list sorted A to Z */
+int test1_match(test1_t * t, void * key)
+{
+    return *(char *)key - t->data;
+}
+
+int test5_match(test5_t * t, void * key)
+{
+    return *(char *)key - t->data;
+}
+
+/* print the data of the item found for each key, '-' for keys not found
+   data is the offset of the char data in the items */
+void find_many_print(char * const * keys, void * const * results, size_t m, size_t missing, size_t data)
+{
+    size_t i;
+
+    for(i=0; i < m; i++)
+        printf("%c:%c ", *keys[i], results[i] ? offsetin(results[i], data, char) : '-');
+    printf("missing: %d\r\n", (int)missing);
+}
+
+void find_many_test(void)
+{
+    static char letters[] = "BDFHJLNPRTVXZ";
+    static char unsorted[] = "ZAHBQD";
+    static char sorted[] = "ABDDQZ";
+    char * keys[6];
+    void * results[6];
+    test1_t buf[26];
+    test1_t * head1;
+    LL_IDX head5 = LL_IDX_NULL;
+    size_t i, missing;
+
+    printf("testing find many\r\n");
+
+    head1 = test1_build(buf, letters);
+    for(i = sizeof(letters) - 1; i-- > 0;)
+    {
+        buf5[i].data = letters[i];
+        test5_push(&head5, &buf5[i]);
+    }
+
+    for(i=0; i < 6; i++) keys[i] = &unsorted[i];
+    missing = test1_find_many(&head1, (void * const *)keys, 6, test1_match, (test1_t **)results);
+    printf("unsorted: "); find_many_print(keys, results, 6, missing, offsetof(test1_t, data));
+    missing = test5_find_many(&head5, (void * const *)keys, 6, test5_match, (test5_t **)results);
+    printf("unsorted index: "); find_many_print(keys, results, 6, missing, offsetof(test5_t, data));
+
+    for(i=0; i < 6; i++) keys[i] = &sorted[i];
+    missing = test1_find_many_sorted(&head1, (void * const *)keys, 6, test1_match, (test1_t **)results);
+    printf("sorted: "); find_many_print(keys, results, 6, missing, offsetof(test1_t, data));
+    missing = test5_find_many_sorted(&head5, (void * const *)keys, 6, test5_match, (test5_t **)results);
+    printf("sorted index: "); find_many_print(keys, results, 6, missing, offsetof(test5_t, data));
+
+    missing = test1_find_many_sorted(&head1, (void * const *)keys, 0, test1_match, (test1_t **)results);
+    printf("no keys, missing: %d\r\n", (int)missing);
+    head1 = NULL;
+    missing = test1_find_many(&head1, (void * const *)keys, 6, test1_match, (test1_t **)results);
+    printf("empty list, missing: %d\r\n", (int)missing);
+}
@@ -0,0 +1,123 @@
+#ifndef __THREAD_H__
+#define __THREAD_H__
+
+/* Thin wrappers over the threading and atomic primitives of each platform,
+   just enough for ThreadPool.c and RcuList.c
+ */
+
+#include <stddef.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <intrin.h>
+
+typedef HANDLE thread_t;
+typedef SRWLOCK mutex_t;
+typedef CONDITION_VARIABLE cond_t;
+
+/* declare a function that can be started with thread_start */
+#define THREAD_FUNCTION(name, arg) DWORD WINAPI name(LPVOID arg)
+#define THREAD_RETURN return 0
+
+static inline int thread_start(thread_t * t, LPTHREAD_START_ROUTINE fn, void * arg)
+{
+    *t = CreateThread(NULL, 0, fn, arg, 0, NULL);
+    return *t ? 0 : -1;
+}
+
+static inline void thread_join(thread_t t)
+{
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+
+static inline size_t thread_cores(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+}
+
+static inline void mutex_init(mutex_t * m) { InitializeSRWLock(m); }
+static inline void mutex_destroy(mutex_t * m) { (void)m; }
+static inline void mutex_lock(mutex_t * m) { AcquireSRWLockExclusive(m); }
+static inline void mutex_unlock(mutex_t * m) { ReleaseSRWLockExclusive(m); }
+
+static inline void cond_init(cond_t * c) { InitializeConditionVariable(c); }
+static inline void cond_destroy(cond_t * c) { (void)c; }
+static inline void cond_wait(cond_t * c, mutex_t * m) { SleepConditionVariableSRW(c, m, INFINITE, 0); }
+static inline void cond_signal(cond_t * c) { WakeConditionVariable(c); }
+static inline void cond_broadcast(cond_t * c) { WakeAllConditionVariable(c); }
+
+#if defined(_M_IX86) || defined(_M_X64)
+/* x86 loads already acquire and stores already release, only stop the compiler reordering */
+#define atomic_compiler_barrier() _ReadWriteBarrier()
+#else
+#define atomic_compiler_barrier() MemoryBarrier()
+#endif
+
+/* load with acquire semantics, later loads can't move before it */
+static inline void * atomic_load_ptr(void * const volatile * p) { void * v = *p; atomic_compiler_barrier(); return v; }
+static inline size_t atomic_load_size(const volatile size_t * p) { size_t v = *p; atomic_compiler_barrier(); return v; }
+/* store with release semantics, earlier stores can't move after it */
+static inline void atomic_store_ptr(void * volatile * p, void * v) { atomic_compiler_barrier(); *p = v; }
+static inline void atomic_store_size(volatile size_t * p, size_t v) { atomic_compiler_barrier(); *p = v; }
+/* full fence, no load or store can move across it */
+static inline void atomic_fence(void) { MemoryBarrier(); }
+
+static inline void thread_yield(void) { SwitchToThread(); }
+
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+typedef pthread_t thread_t;
+typedef pthread_mutex_t mutex_t;
+typedef pthread_cond_t cond_t;
+
+/* declare a function that can be started with thread_start */
+#define THREAD_FUNCTION(name, arg) void * name(void * arg)
+#define THREAD_RETURN return NULL
+
+static inline int thread_start(thread_t * t, void * (*fn)(void *), void * arg)
+{
+    return pthread_create(t, NULL, fn, arg) == 0 ? 0 : -1;
+}
+
+static inline void thread_join(thread_t t)
+{
+    pthread_join(t, NULL);
+}
+
+static inline size_t thread_cores(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (size_t)n : 1;
+}
+
+static inline void mutex_init(mutex_t * m) { pthread_mutex_init(m, NULL); }
+static inline void mutex_destroy(mutex_t * m) { pthread_mutex_destroy(m); }
+static inline void mutex_lock(mutex_t * m) { pthread_mutex_lock(m); }
+static inline void mutex_unlock(mutex_t * m) { pthread_mutex_unlock(m); }
+
+static inline void cond_init(cond_t * c) { pthread_cond_init(c, NULL); }
+static inline void cond_destroy(cond_t * c) { pthread_cond_destroy(c); }
+static inline void cond_wait(cond_t * c, mutex_t * m) { pthread_cond_wait(c, m); }
+static inline void cond_signal(cond_t * c) { pthread_cond_signal(c); }
+static inline void cond_broadcast(cond_t * c) { pthread_cond_broadcast(c); }
+
+/* load with acquire semantics, later loads can't move before it */
+static inline void * atomic_load_ptr(void * const volatile * p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static inline size_t atomic_load_size(const volatile size_t * p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+/* store with release semantics, earlier stores can't move after it */
+static inline void atomic_store_ptr(void * volatile * p, void * v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+static inline void atomic_store_size(volatile size_t * p, size_t v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+/* full fence, no load or store can move across it */
+static inline void atomic_fence(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+static inline void thread_yield(void) { sched_yield(); }
+
+#endif // _WIN32
+
+#endif // !__THREAD_H__
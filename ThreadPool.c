@@ -0,0 +1,286 @@
+#include <stdlib.h>
+#include "Thread.h"
+#include "ThreadPool.h"
+
+typedef struct {
+    void (*fn)(void *);
+    void * arg;
+    TP_GROUP * group;
+} TP_TASK;
+
+/* double ended queue of tasks in a ring buffer
+   the owning worker pushes and pops at the back, thieves steal from the front
+ */
+typedef struct {
+    mutex_t lock;
+    TP_TASK * tasks;
+    size_t size;  /* capacity of tasks, a power of 2 */
+    size_t front; /* index of the oldest task */
+    size_t count;
+    THREAD_POOL * pool;
+} TP_QUEUE;
+
+struct THREAD_POOL {
+    size_t threads;
+    thread_t * handles;
+    TP_QUEUE * queues; /* one for each thread */
+    mutex_t lock;      /* guards everything below, and the pending count of every group */
+    cond_t work;       /* signalled when a task is queued */
+    cond_t done;       /* broadcast when a group has no pending tasks */
+    size_t queued;     /* number of tasks in all queues */
+    size_t next;       /* queue the next submitted task goes to */
+    int stop;
+};
+
+/* add task to the back of q, growing the ring buffer if full
+   returns 0 on success
+ */
+static int tp_push(TP_QUEUE * const q, const TP_TASK * const task)
+{
+    TP_TASK * tasks;
+    size_t i, size;
+
+    mutex_lock(&q->lock);
+    if(q->count == q->size)
+    {
+        size = q->size ? q->size * 2 : 64;
+        tasks = malloc(size * sizeof(TP_TASK));
+        if(tasks == NULL)
+        {
+            mutex_unlock(&q->lock);
+            return -1;
+        }
+        /* unwrap the ring into the new buffer */
+        for(i=0; i < q->count; i++)
+            tasks[i] = q->tasks[(q->front + i) & (q->size - 1)];
+        free(q->tasks);
+        q->tasks = tasks;
+        q->size = size;
+        q->front = 0;
+    }
+    q->tasks[(q->front + q->count) & (q->size - 1)] = *task;
+    q->count++;
+    mutex_unlock(&q->lock);
+    return 0;
+}
+
+/* remove the newest (back = 1) or oldest (back = 0) task from q
+   returns 1 if a task was removed
+ */
+static int tp_pop(TP_QUEUE * const q, TP_TASK * const task, const int back)
+{
+    int found = 0;
+
+    mutex_lock(&q->lock);
+    if(q->count)
+    {
+        if(back)
+        {
+            *task = q->tasks[(q->front + q->count - 1) & (q->size - 1)];
+        }
+        else
+        {
+            *task = q->tasks[q->front];
+            q->front = (q->front + 1) & (q->size - 1);
+        }
+        q->count--;
+        found = 1;
+    }
+    mutex_unlock(&q->lock);
+    return found;
+}
+
+/* take a task from queue "self", or steal one from any other queue
+   self may be pool->threads for a thread that owns no queue
+   returns 1 if a task was taken
+ */
+static int tp_take(THREAD_POOL * const pool, const size_t self, TP_TASK * const task)
+{
+    size_t i;
+    int found = 0;
+
+    if(self < pool->threads) found = tp_pop(&pool->queues[self], task, 1);
+
+    /* steal, starting with the next queue so thieves spread out */
+    for(i=1; !found && i <= pool->threads; i++)
+        found = tp_pop(&pool->queues[(self + i) % pool->threads], task, 0);
+
+    if(found)
+    {
+        mutex_lock(&pool->lock);
+        pool->queued--;
+        mutex_unlock(&pool->lock);
+    }
+    return found;
+}
+
+/* run task and mark it finished in its group */
+static void tp_run(THREAD_POOL * const pool, const TP_TASK * const task)
+{
+    task->fn(task->arg);
+
+    mutex_lock(&pool->lock);
+    if(--task->group->pending == 0) cond_broadcast(&pool->done);
+    mutex_unlock(&pool->lock);
+}
+
+static THREAD_FUNCTION(tp_worker, arg)
+{
+    TP_QUEUE * q = arg;
+    THREAD_POOL * pool = q->pool;
+    const size_t self = q - pool->queues;
+    TP_TASK task;
+    int stop;
+
+    while(1)
+    {
+        if(tp_take(pool, self, &task))
+        {
+            tp_run(pool, &task);
+            continue;
+        }
+
+        /* sleep until there is work, a task may have been queued
+           after the queues were checked, so check the count again */
+        mutex_lock(&pool->lock);
+        while(pool->queued == 0 && !pool->stop)
+            cond_wait(&pool->work, &pool->lock);
+        stop = pool->stop && pool->queued == 0;
+        mutex_unlock(&pool->lock);
+
+        if(stop) break;
+    }
+
+    THREAD_RETURN;
+}
+
+/* create a pool of "threads" workers, or one per core if threads is 0
+   returns the pool, or NULL on failure
+ */
+THREAD_POOL * tp_create(size_t threads)
+{
+    THREAD_POOL * pool;
+    size_t i, started;
+
+    if(threads == 0) threads = thread_cores();
+
+    pool = calloc(1, sizeof(THREAD_POOL));
+    if(pool == NULL) return NULL;
+    pool->handles = calloc(threads, sizeof(thread_t));
+    pool->queues = calloc(threads, sizeof(TP_QUEUE));
+    if(pool->handles == NULL || pool->queues == NULL)
+    {
+        free(pool->handles);
+        free(pool->queues);
+        free(pool);
+        return NULL;
+    }
+
+    pool->threads = threads;
+    mutex_init(&pool->lock);
+    cond_init(&pool->work);
+    cond_init(&pool->done);
+    for(i=0; i < threads; i++)
+    {
+        mutex_init(&pool->queues[i].lock);
+        pool->queues[i].pool = pool;
+    }
+
+    for(started=0; started < threads; started++)
+    {
+        if(thread_start(&pool->handles[started], tp_worker, &pool->queues[started]) != 0)
+        {
+            /* stop the workers which did start */
+            for(i=started; i < threads; i++)
+                mutex_destroy(&pool->queues[i].lock);
+            pool->threads = started;
+            tp_destroy(pool);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+/* finish all queued tasks, then stop the workers and free the pool */
+void tp_destroy(THREAD_POOL * const pool)
+{
+    size_t i;
+
+    if(pool == NULL) return;
+
+    mutex_lock(&pool->lock);
+    pool->stop = 1;
+    cond_broadcast(&pool->work);
+    mutex_unlock(&pool->lock);
+
+    for(i=0; i < pool->threads; i++)
+        thread_join(pool->handles[i]);
+
+    for(i=0; i < pool->threads; i++)
+    {
+        free(pool->queues[i].tasks);
+        mutex_destroy(&pool->queues[i].lock);
+    }
+    cond_destroy(&pool->done);
+    cond_destroy(&pool->work);
+    mutex_destroy(&pool->lock);
+    free(pool->queues);
+    free(pool->handles);
+    free(pool);
+}
+
+/* number of worker threads in the pool */
+size_t tp_threads(const THREAD_POOL * const pool)
+{
+    return pool->threads;
+}
+
+/* queue fn(arg) to run on one of the workers as part of group
+   returns 0 on success, the task is not queued on failure
+ */
+int tp_submit(THREAD_POOL * const pool, TP_GROUP * const group, void (*fn)(void *), void * const arg)
+{
+    TP_TASK task = { fn, arg, group };
+
+    mutex_lock(&pool->lock);
+    if(tp_push(&pool->queues[pool->next++ % pool->threads], &task) != 0)
+    {
+        mutex_unlock(&pool->lock);
+        return -1;
+    }
+    group->pending++;
+    pool->queued++;
+    cond_signal(&pool->work);
+    mutex_unlock(&pool->lock);
+    return 0;
+}
+
+/* wait until every task of group has finished
+   the calling thread runs queued tasks while it waits
+ */
+void tp_wait(THREAD_POOL * const pool, TP_GROUP * const group)
+{
+    TP_TASK task;
+    size_t pending;
+
+    while(1)
+    {
+        mutex_lock(&pool->lock);
+        pending = group->pending;
+        mutex_unlock(&pool->lock);
+        if(pending == 0) return;
+
+        if(tp_take(pool, pool->threads, &task))
+        {
+            tp_run(pool, &task);
+            continue;
+        }
+
+        /* nothing left to steal, the remaining tasks are running */
+        mutex_lock(&pool->lock);
+        while(group->pending && pool->queued == 0)
+            cond_wait(&pool->done, &pool->lock);
+        mutex_unlock(&pool->lock);
+    }
+}
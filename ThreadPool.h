@@ -0,0 +1,23 @@
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <stddef.h>
+
+/* A reusable pool of worker threads. Each worker has its own queue of tasks,
+   it runs the newest task from its own queue first and when that is empty
+   steals the oldest task from the queue of another worker.
+ */
+typedef struct THREAD_POOL THREAD_POOL;
+
+/* a set of tasks that can be waited on together */
+typedef struct {
+    size_t pending;
+} TP_GROUP;
+
+THREAD_POOL * tp_create(size_t threads);
+void tp_destroy(THREAD_POOL * pool);
+size_t tp_threads(const THREAD_POOL * pool);
+int tp_submit(THREAD_POOL * pool, TP_GROUP * group, void (*fn)(void *), void * arg);
+void tp_wait(THREAD_POOL * pool, TP_GROUP * group);
+
+#endif // !__THREAD_POOL_H__
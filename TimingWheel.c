@@ -0,0 +1,154 @@
+#include "LinkedList.h"
+#include "TimingWheel.h"
+
+/* assumes variable "o" is the offset where the TW_LINK element is located */
+#define LINK(x) (&offsetin(x, o, TW_LINK))
+
+/* offset of the next element, for the ll_* functions */
+#define NEXT_OFFSET (o + offsetof(TW_LINK, next))
+
+/* number of ticks covered by one slot of level */
+#define TW_SPAN(level) ((uint64_t)1 << (TW_BITS * (level)))
+
+/* start an empty wheel at tick now, for items with a TW_LINK at offset o
+   Complexity O(TW_LEVELS * TW_SLOTS)
+ */
+void tw_init(TIMING_WHEEL * const wheel, const size_t o, const uint64_t now)
+{
+    int level, i;
+
+    for(level=0; level < TW_LEVELS; level++)
+        for(i=0; i < TW_SLOTS; i++)
+            wheel->slots[level][i] = NULL;
+    wheel->now = now;
+    wheel->count = 0;
+    wheel->o = o;
+}
+
+/* link item into the slot that tick "expires" falls in, relative to the current tick
+   expires must not be before the current tick, an item on the current tick
+   is only expired if advance is still to visit its slot
+   items past the last level are placed in its furthest slot, and placed
+   again when that slot is cascaded
+   Complexity O(1)
+ */
+static void tw_insert(TIMING_WHEEL * const wheel, void * const item, uint64_t expires)
+{
+    const size_t o = wheel->o;
+    TW_LINK * const l = LINK(item);
+    uint64_t delta = expires - wheel->now;
+    void ** slot;
+    int level;
+
+    if(delta >= TW_SPAN(TW_LEVELS))
+    {
+        expires = wheel->now + TW_SPAN(TW_LEVELS) - 1;
+        delta = TW_SPAN(TW_LEVELS) - 1;
+    }
+
+    /* the lowest level whose slots reach that far */
+    for(level=0; delta >= TW_SPAN(level + 1); level++)
+        ;
+
+    slot = &wheel->slots[level][(expires >> (TW_BITS * level)) & (TW_SLOTS - 1)];
+    ll_push(slot, NEXT_OFFSET, item);
+    l->pprev = slot;
+    if(l->next) LINK(l->next)->pprev = &l->next;
+}
+
+/* schedule item to expire on tick expires, rescheduling it if already scheduled
+   tw.pprev must be NULL for an item that was never scheduled
+   an item expiring on or before the current tick expires on the next one
+   Complexity O(1)
+ */
+void tw_schedule(TIMING_WHEEL * const wheel, void * const item, const uint64_t expires)
+{
+    const size_t o = wheel->o;
+
+    tw_cancel(wheel, item);
+    LINK(item)->expires = expires;
+    tw_insert(wheel, item, expires > wheel->now ? expires : wheel->now + 1);
+    wheel->count++;
+}
+
+/* remove item from the wheel
+   returns 1 if item was scheduled, 0 otherwise
+   Complexity O(1)
+ */
+int tw_cancel(TIMING_WHEEL * const wheel, void * const item)
+{
+    const size_t o = wheel->o;
+    TW_LINK * const l = LINK(item);
+
+    if(l->pprev == NULL) return 0;
+
+    *l->pprev = l->next;
+    if(l->next) LINK(l->next)->pprev = l->pprev;
+    l->pprev = NULL;
+    wheel->count--;
+    return 1;
+}
+
+/* place every item of a higher level slot again, relative to the current tick
+   the slot of the current tick on level 0 is yet to be expired, so items
+   due on it are expired by the same advance
+   Complexity O(items in slot)
+ */
+static void tw_cascade(TIMING_WHEEL * const wheel, void ** const slot)
+{
+    const size_t o = wheel->o;
+    void * x = *slot, * next;
+
+    *slot = NULL;
+    for(; x; x = next)
+    {
+        next = LINK(x)->next;
+        tw_insert(wheel, x, LINK(x)->expires);
+    }
+}
+
+/* advance the wheel to tick now
+   returns the items that expired, linked through tw.next tick by tick,
+   with tw.pprev set to NULL
+   scheduling an expired item links it into a slot through tw.next, which
+   cuts the rest of the chain off, so callers read tw.next first
+   Complexity O(ticks advanced + items expired + items cascaded)
+ */
+void * tw_advance(TIMING_WHEEL * const wheel, const uint64_t now)
+{
+    const size_t o = wheel->o;
+    void * expired = NULL, * x;
+    void ** tail = &expired, ** slot;
+    uint64_t t;
+    int level;
+
+    while(wheel->now < now)
+    {
+        /* nothing left to expire, skip the remaining ticks */
+        if(wheel->count == 0)
+        {
+            wheel->now = now;
+            break;
+        }
+
+        t = ++wheel->now;
+
+        /* each time a level wraps around, cascade the next slot of the level above */
+        for(level=1; level < TW_LEVELS && (t & (TW_SPAN(level) - 1)) == 0; level++)
+            tw_cascade(wheel, &wheel->slots[level][(t >> (TW_BITS * level)) & (TW_SLOTS - 1)]);
+
+        /* move the whole slot to the end of the expired chain */
+        slot = &wheel->slots[0][t & (TW_SLOTS - 1)];
+        if(*slot == NULL) continue;
+        *tail = *slot;
+        *slot = NULL;
+        for(x = *tail; x; x = LINK(x)->next)
+        {
+            LINK(x)->pprev = NULL;
+            wheel->count--;
+            tail = &LINK(x)->next;
+        }
+    }
+
+    return expired;
+}
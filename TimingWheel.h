@@ -0,0 +1,109 @@
+#ifndef __TIMING_WHEEL_H__
+#define __TIMING_WHEEL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Template.h"
+
+/* A hierarchical timing wheel of TW_LEVELS levels with TW_SLOTS slots each.
+   A slot of level 0 holds the items expiring on one tick, a slot of level L
+   covers TW_SLOTS^L ticks. When level 0 wraps around, the next slot of
+   level 1 is cascaded: its items are scheduled again, now landing in level 0,
+   and so on up the levels.
+
+   Each slot is an intrusive list. Each item holds a TW_LINK named tw:
+    * next:    the next item in the same slot, or in the expired chain
+    * pprev:   the pointer that points to this item, NULL if not scheduled
+    * expires: the tick the item expires on
+   pprev lets an item be cancelled without searching its slot.
+ */
+
+#define TW_BITS 6
+#define TW_SLOTS (1 << TW_BITS)
+#define TW_LEVELS 4
+
+typedef struct TW_LINK {
+    void * next;
+    void ** pprev;
+    uint64_t expires;
+} TW_LINK;
+
+typedef struct {
+    void * slots[TW_LEVELS][TW_SLOTS];
+    uint64_t now;   /* the last tick that was advanced to */
+    size_t count;   /* number of scheduled items */
+    size_t o;       /* offset of the TW_LINK in each item */
+} TIMING_WHEEL;
+
+void tw_init(TIMING_WHEEL * wheel, size_t o, uint64_t now);
+void tw_schedule(TIMING_WHEEL * wheel, void * item, uint64_t expires);
+int tw_cancel(TIMING_WHEEL * wheel, void * item);
+void * tw_advance(TIMING_WHEEL * wheel, uint64_t now);
+
+#endif // !__TIMING_WHEEL_H__
+
+#if defined(TEMPLATE_PREFIX) && defined(TEMPLATE_STRUCT)
+
+/*shorter versions of the template definitions*/
+#define PREFIX PPCAT(TEMPLATE_PREFIX, _)
+#define STRUCT TEMPLATE_STRUCT
+#define OFFSET offsetof(STRUCT, tw)
+
+#define FUNCTION(name) PPCAT(PREFIX, name)
+
+/* start an empty wheel at tick now
+   Complexity O(TW_LEVELS * TW_SLOTS)
+ */
+static inline void FUNCTION(init)(TIMING_WHEEL * wheel, uint64_t now)
+{
+    tw_init(wheel, OFFSET, now);
+}
+
+/* schedule item to expire on tick expires, rescheduling it if already scheduled
+   an item expiring on or before the current tick expires on the next one
+   Complexity O(1)
+ */
+static inline void FUNCTION(schedule)(TIMING_WHEEL * wheel, STRUCT * item, uint64_t expires)
+{
+    tw_schedule(wheel, item, expires);
+}
+
+/* remove item from the wheel
+   returns 1 if item was scheduled, 0 otherwise
+   Complexity O(1)
+ */
+static inline int FUNCTION(cancel)(TIMING_WHEEL * wheel, STRUCT * item)
+{
+    return tw_cancel(wheel, item);
+}
+
+/* returns 1 if item is scheduled, 0 otherwise
+   Complexity O(1)
+ */
+static inline int FUNCTION(pending)(const STRUCT * item)
+{
+    return item->tw.pprev != NULL;
+}
+
+/* advance the wheel to tick now
+   returns the items that expired, linked through tw.next in the order they expired
+   scheduling an expired item reuses its tw.next, so read tw.next before
+   scheduling the item again
+   Complexity O(ticks advanced + items expired + items cascaded)
+ */
+static inline STRUCT * FUNCTION(advance)(TIMING_WHEEL * wheel, uint64_t now)
+{
+    return (STRUCT *)tw_advance(wheel, now);
+}
+
+/* un-define all the template magic */
+#undef PREFIX
+#undef STRUCT
+#undef OFFSET
+
+#undef TEMPLATE_PREFIX
+#undef TEMPLATE_STRUCT
+
+#undef FUNCTION
+
+#endif // TEMPLATE